@@ -36,12 +36,26 @@ namespace big
 			return true;
 		}
 
+		std::error_code error;
+		const auto file_size = std::filesystem::file_size(m_cache_file.get_path(), error);
+
 		auto file = std::ifstream(m_cache_file.get_path(), std::ios::binary);
 
-		file.read(reinterpret_cast<char*>(&m_cache_header), sizeof(m_cache_header));
+		// The data size is only trusted once it matches the file, a truncated or corrupted cache is a miss.
+		if (error || file_size < sizeof(m_cache_header) || !file.read(reinterpret_cast<char*>(&m_cache_header), sizeof(m_cache_header))
+		    || m_cache_header.m_data_size != file_size - sizeof(m_cache_header))
+		{
+			m_cache_header = {};
+			return false;
+		}
 
 		m_data = std::make_unique<uint8_t[]>(m_cache_header.m_data_size);
-		file.read(reinterpret_cast<char*>(m_data.get()), m_cache_header.m_data_size);
+		if (!file.read(reinterpret_cast<char*>(m_data.get()), m_cache_header.m_data_size))
+		{
+			m_data.reset();
+			m_cache_header = {};
+			return false;
+		}
 
 		file.close();
 		return true;
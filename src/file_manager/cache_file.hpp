@@ -37,7 +37,7 @@ namespace big
 		/// <summary>
 		/// Attempts to load the cache from disk
 		/// </summary>
-		/// <returns>True after successfully loading the data, false if the file didn't exist.</returns>
+		/// <returns>True after successfully loading the data, false if the file didn't exist or its size doesn't match its header.</returns>
 		bool load();
 
 		/// <summary>
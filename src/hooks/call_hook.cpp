@@ -1,5 +1,7 @@
 #include "call_hook.hpp"
 
+#include "hook_transaction.hpp"
+
 #include <windows.h>
 
 namespace
@@ -49,15 +51,28 @@ namespace big
 	call_hook::~call_hook()
 	{
 		disable();
+		hook_transaction::flush(this);
 	}
 
 	void call_hook::enable()
 	{
-		memcpy(m_location, m_patched_bytes, 5);
+		hook_transaction::execute(
+		    this,
+		    [this]
+		    {
+			    memcpy(m_location, m_patched_bytes, 5);
+		    },
+		    false);
 	}
 
 	void call_hook::disable()
 	{
-		memcpy(m_location, m_original_bytes, 5);
+		hook_transaction::execute(
+		    this,
+		    [this]
+		    {
+			    memcpy(m_location, m_original_bytes, 5);
+		    },
+		    false);
 	}
 } // namespace big
@@ -1,5 +1,6 @@
 #include "detour_hook.hpp"
 
+#include "hook_transaction.hpp"
 #include "memory/handle.hpp"
 #include "threads/util.hpp"
 
@@ -60,14 +61,18 @@ namespace big
 
 	detour_hook::~detour_hook() noexcept
 	{
-		if (!m_target)
-		{
-			return;
-		}
+		hook_transaction::flush(this);
+	}
+
+	// Queued operations capture the address of the hook, they are applied before it moves.
+	static detour_hook& flush_queued(detour_hook& hook)
+	{
+		hook_transaction::flush(&hook);
+		return hook;
 	}
 
 	detour_hook::detour_hook(detour_hook&& that) :
-	    m_name(std::move(that.m_name)),
+	    m_name(std::move(flush_queued(that).m_name)),
 	    m_original(std::move(that.m_original)),
 	    m_target(std::move(that.m_target)),
 	    m_detour(std::move(that.m_detour)),
@@ -82,26 +87,16 @@ namespace big
 			return;
 		}
 
-		if (!m_detour_object->isHooked())
-		{
-			auto suspended_thread_here = false;
-			if (!threads::are_suspended)
-			{
-				suspended_thread_here = true;
-
-				threads::suspend_all_but_one();
-			}
-
-			if (!m_detour_object->hook())
-			{
-				LOG(ERROR) << std::format("Failed to create hook '{}' at 0x{:X}", m_name, uintptr_t(m_target));
-			}
-
-			if (suspended_thread_here)
-			{
-				threads::resume_all();
-			}
-		}
+		hook_transaction::execute(
+		    this,
+		    [this]
+		    {
+			    if (!m_detour_object->isHooked() && !m_detour_object->hook())
+			    {
+				    LOG(ERROR) << std::format("Failed to create hook '{}' at 0x{:X}", m_name, uintptr_t(m_target));
+			    }
+		    },
+		    true);
 	}
 
 	void detour_hook::disable()
@@ -111,26 +106,16 @@ namespace big
 			return;
 		}
 
-		if (m_detour_object->isHooked())
-		{
-			auto suspended_thread_here = false;
-			if (!threads::are_suspended)
-			{
-				suspended_thread_here = true;
-
-				threads::suspend_all_but_one();
-			}
-
-			if (!m_detour_object->unHook())
-			{
-				LOG(ERROR) << "Failed to disable hook '" << m_name << "' at 0x" << HEX_TO_UPPER(uintptr_t(m_target)) << "(error: " << m_name << ")";
-			}
-
-			if (suspended_thread_here)
-			{
-				threads::resume_all();
-			}
-		}
+		hook_transaction::execute(
+		    this,
+		    [this]
+		    {
+			    if (m_detour_object->isHooked() && !m_detour_object->unHook())
+			    {
+				    LOG(ERROR) << "Failed to disable hook '" << m_name << "' at 0x" << HEX_TO_UPPER(uintptr_t(m_target)) << "(error: " << m_name << ")";
+			    }
+		    },
+		    true);
 	}
 
 	DWORD exp_handler(PEXCEPTION_POINTERS exp, const std::string& name)
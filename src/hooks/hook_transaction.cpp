@@ -0,0 +1,135 @@
+#include "hook_transaction.hpp"
+
+#include "threads/util.hpp"
+
+#include <algorithm>
+#include <iterator>
+#include <mutex>
+#include <thread>
+#include <utility>
+#include <vector>
+
+namespace big
+{
+	struct pending_operation
+	{
+		const void* m_owner;
+		// Thread whose transaction queued the operation, which commits it.
+		std::thread::id m_thread;
+		std::function<void()> m_operation;
+		bool m_writes_code;
+	};
+
+	static thread_local int t_transaction_depth = 0;
+	static thread_local bool t_applying         = false;
+
+	// Shared by every thread, so that an owner destroyed on another thread than the one which queued its operations still flushes them.
+	static std::mutex s_pending_lock;
+	static std::vector<pending_operation> s_pending_operations;
+
+	// Removes the matching operations from the queue, in queuing order. The lock is not held while they are applied,
+	// since they call back into execute.
+	template<typename Predicate>
+	static std::vector<pending_operation> take_pending_operations(Predicate taken)
+	{
+		std::scoped_lock lock(s_pending_lock);
+
+		const auto first = std::stable_partition(s_pending_operations.begin(),
+		                                         s_pending_operations.end(),
+		                                         [&taken](const pending_operation& operation)
+		                                         {
+			                                         return !taken(operation);
+		                                         });
+
+		std::vector<pending_operation> operations(std::make_move_iterator(first), std::make_move_iterator(s_pending_operations.end()));
+		s_pending_operations.erase(first, s_pending_operations.end());
+		return operations;
+	}
+
+	static void apply(const std::vector<pending_operation>& operations)
+	{
+		if (operations.empty())
+		{
+			return;
+		}
+
+		const auto writes_code = std::ranges::any_of(operations, &pending_operation::m_writes_code);
+
+		auto suspended_thread_here = false;
+		if (writes_code && !threads::are_suspended)
+		{
+			suspended_thread_here = true;
+
+			threads::suspend_all_but_one();
+		}
+
+		// The operations call back into execute, which must run them instead of queuing them again.
+		const auto was_applying = std::exchange(t_applying, true);
+		for (const auto& operation : operations)
+		{
+			operation.m_operation();
+		}
+		t_applying = was_applying;
+
+		if (suspended_thread_here)
+		{
+			threads::resume_all();
+		}
+	}
+
+	hook_transaction::hook_transaction()
+	{
+		t_transaction_depth++;
+	}
+
+	hook_transaction::~hook_transaction()
+	{
+		commit();
+	}
+
+	void hook_transaction::commit()
+	{
+		if (m_committed)
+		{
+			return;
+		}
+
+		m_committed = true;
+		if (--t_transaction_depth > 0)
+		{
+			return;
+		}
+
+		apply(take_pending_operations(
+		    [thread = std::this_thread::get_id()](const pending_operation& operation)
+		    {
+			    return operation.m_thread == thread;
+		    }));
+	}
+
+	bool hook_transaction::active()
+	{
+		return t_transaction_depth > 0 && !t_applying;
+	}
+
+	void hook_transaction::execute(const void* owner, std::function<void()> operation, bool writes_code)
+	{
+		if (active())
+		{
+			std::scoped_lock lock(s_pending_lock);
+			s_pending_operations.push_back({owner, std::this_thread::get_id(), std::move(operation), writes_code});
+			return;
+		}
+
+		apply({{owner, std::move(operation), writes_code}});
+	}
+
+	void hook_transaction::flush(const void* owner)
+	{
+		apply(take_pending_operations(
+		    [owner](const pending_operation& operation)
+		    {
+			    return operation.m_owner == owner;
+		    }));
+	}
+} // namespace big
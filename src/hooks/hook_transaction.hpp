@@ -0,0 +1,52 @@
+#pragma once
+
+#include <functional>
+
+namespace big
+{
+	/**
+	 * @brief Batches hook and patch changes so they share a single thread suspension.
+	 *
+	 * While a transaction is open on a thread, the enable / disable calls that thread makes on detour_hook, vmt_hook, vtable_hook,
+	 * call_hook, iat_hook and memory::byte_patch are queued. commit() then applies them in call order, with every other thread
+	 * suspended once instead of once per hook. Transactions nest, only the outermost one commits.
+	 *
+	 * Nothing runs Lua or game code while the threads are suspended, only the queued operations.
+	 */
+	class hook_transaction
+	{
+	public:
+		hook_transaction();
+		// Commits if commit() was not called.
+		~hook_transaction();
+
+		hook_transaction(hook_transaction&& that)            = delete;
+		hook_transaction& operator=(hook_transaction&& that) = delete;
+		hook_transaction(const hook_transaction&)            = delete;
+		hook_transaction& operator=(const hook_transaction&) = delete;
+
+		void commit();
+
+		// A transaction is open on the calling thread.
+		static bool active();
+
+		/**
+		 * @brief Runs the operation now, or queues it in the transaction open on the calling thread.
+		 *
+		 * @param owner Object the operation works on, see flush.
+		 * @param writes_code The operation rewrites code other threads may be running, so it runs with them suspended.
+		 * Operations that never suspended on their own (pointer swaps, call_hook, byte_patch) pass false, in a transaction
+		 * they still land inside its suspension when another operation needs one.
+		 */
+		static void execute(const void* owner, std::function<void()> operation, bool writes_code);
+
+		/**
+		 * @brief Runs the queued operations of the owner right away, whichever thread queued them. Hooks and patches call this
+		 * before being destroyed or moved, so that nothing is left queued on a dead object.
+		 */
+		static void flush(const void* owner);
+
+	private:
+		bool m_committed{};
+	};
+} // namespace big
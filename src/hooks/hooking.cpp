@@ -1,7 +1,7 @@
 #include "hooks/hooking.hpp"
 
+#include "hooks/hook_transaction.hpp"
 #include "memory/module.hpp"
-#include "threads/util.hpp"
 
 namespace big
 {
@@ -31,23 +31,14 @@ namespace big
 
 	void hooking::enable()
 	{
-		auto suspended_thread_here = false;
-		if (!threads::are_suspended)
-		{
-			suspended_thread_here = true;
-
-			threads::suspend_all_but_one();
-		}
+		hook_transaction transaction;
 
 		for (auto& detour_hook_helper : m_detour_hook_helpers)
 		{
 			detour_hook_helper.m_detour_hook->enable();
 		}
 
-		if (suspended_thread_here)
-		{
-			threads::resume_all();
-		}
+		transaction.commit();
 
 		m_enabled = true;
 	}
@@ -56,23 +47,14 @@ namespace big
 	{
 		m_enabled = false;
 
-		auto suspended_thread_here = false;
-		if (!threads::are_suspended)
-		{
-			suspended_thread_here = true;
-
-			threads::suspend_all_but_one();
-		}
+		hook_transaction transaction;
 
 		for (auto& detour_hook_helper : m_detour_hook_helpers)
 		{
 			detour_hook_helper.m_detour_hook->disable();
 		}
 
-		if (suspended_thread_here)
-		{
-			threads::resume_all();
-		}
+		transaction.commit();
 
 		m_detour_hook_helpers.clear();
 	}
@@ -1,6 +1,8 @@
 #pragma once
 #include "call_hook.hpp"
 #include "detour_hook.hpp"
+#include "hook_transaction.hpp"
+#include "iat_hook.hpp"
 #include "threads/util.hpp"
 #include "vmt_hook.hpp"
 #include "vtable_hook.hpp"
@@ -141,13 +143,7 @@ namespace big
 
 			static void* execute_queue()
 			{
-				auto suspended_thread_here = false;
-				if (!threads::are_suspended)
-				{
-					suspended_thread_here = true;
-
-					threads::suspend_all_but_one();
-				}
+				hook_transaction transaction;
 
 				for (const auto i : m_detour_hook_helpers_queue)
 				{
@@ -156,10 +152,7 @@ namespace big
 
 				m_detour_hook_helpers_queue.clear();
 
-				if (suspended_thread_here)
-				{
-					threads::resume_all();
-				}
+				transaction.commit();
 
 				return nullptr;
 			}
@@ -0,0 +1,136 @@
+#include "iat_hook.hpp"
+
+#include "hook_transaction.hpp"
+#include "memory/module.hpp"
+
+#include <logger/logger.hpp>
+
+namespace big
+{
+	iat_hook::iat_hook(const std::string& name, void** slot, void* detour) :
+	    m_name(name),
+	    m_slot(slot),
+	    m_original(slot ? *slot : nullptr),
+	    m_detour(detour),
+	    m_enabled(false)
+	{
+	}
+
+	iat_hook::iat_hook(const std::string& name, const memory::module& module, std::string_view dll_name, std::string_view symbol_name, void* detour) :
+	    iat_hook(name, module.get_import_slot(dll_name, symbol_name).as<void**>(), detour)
+	{
+		if (!m_slot)
+		{
+			LOG(ERROR) << std::format("Failed to create hook '{}': {} does not import {}!{}", m_name, module.name(), dll_name, symbol_name);
+		}
+	}
+
+	iat_hook::~iat_hook() noexcept
+	{
+		disable();
+		hook_transaction::flush(this);
+	}
+
+	void* iat_hook::exchange_slot(void* value, void* comparand)
+	{
+		// The IAT usually lives in .rdata and gets write protected once the loader resolved it.
+		DWORD old_protect;
+		if (!VirtualProtect(m_slot, sizeof(void*), PAGE_READWRITE, &old_protect))
+		{
+			LOG(ERROR) << std::format("Failed to unprotect the import slot of hook '{}' at 0x{:X}", m_name, uintptr_t(m_slot));
+			return nullptr;
+		}
+
+		// A single aligned pointer store, threads calling through the slot see either the old or the new function.
+		const auto previous = InterlockedCompareExchangePointer(m_slot, value, comparand);
+
+		DWORD temp;
+		VirtualProtect(m_slot, sizeof(void*), old_protect, &temp);
+		return previous;
+	}
+
+	void iat_hook::enable()
+	{
+		if (!m_slot)
+		{
+			return;
+		}
+
+		hook_transaction::execute(
+		    this,
+		    [this]
+		    {
+			    if (m_enabled)
+			    {
+				    return;
+			    }
+
+			    // The original is set before the detour is published, so a call entering the detour right after the swap already chains
+			    // to it. Another hook or a late bind may change the slot in between, the swap is then retried with its new value.
+			    while (true)
+			    {
+				    const auto current = *static_cast<void* volatile*>(m_slot);
+				    if (!current)
+				    {
+					    return;
+				    }
+
+				    m_original          = current;
+				    const auto previous = exchange_slot(m_detour, current);
+				    if (!previous)
+				    {
+					    return;
+				    }
+
+				    if (previous == current)
+				    {
+					    m_enabled = true;
+					    return;
+				    }
+			    }
+		    },
+		    false);
+	}
+
+	void iat_hook::disable()
+	{
+		if (!m_slot)
+		{
+			return;
+		}
+
+		hook_transaction::execute(
+		    this,
+		    [this]
+		    {
+			    if (!m_enabled)
+			    {
+				    return;
+			    }
+
+			    // Whatever replaced the detour since, like a hook installed on top of this one, is left in place.
+			    const auto previous = exchange_slot(m_original, m_detour);
+			    if (!previous)
+			    {
+				    return;
+			    }
+
+			    if (previous != m_detour)
+			    {
+				    LOG(WARNING) << std::format("Hook '{}' left its import slot at 0x{:X} as is, it holds 0x{:X} instead of the detour", m_name, uintptr_t(m_slot), uintptr_t(previous));
+			    }
+			    m_enabled = false;
+		    },
+		    false);
+	}
+
+	bool iat_hook::valid() const
+	{
+		return m_slot != nullptr;
+	}
+
+	bool iat_hook::enabled() const
+	{
+		return m_enabled;
+	}
+} // namespace big
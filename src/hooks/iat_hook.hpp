@@ -0,0 +1,53 @@
+#pragma once
+
+#include <string>
+#include <string_view>
+
+namespace memory
+{
+	class module;
+}
+
+namespace big
+{
+	/**
+	 * @brief Hooks an import of a module by swapping its import address table slot.
+	 * No trampoline and no thread suspension: calls made through the slot pick the detour up as soon as the pointer is swapped,
+	 * and the original is still called directly. Only the calls of that module are hooked, other modules keep their own slot.
+	 */
+	class iat_hook
+	{
+	public:
+		explicit iat_hook(const std::string& name, void** slot, void* detour);
+		// The slot is looked up in the import index of the module, the hook stays invalid if the module does not import the symbol.
+		explicit iat_hook(const std::string& name, const memory::module& module, std::string_view dll_name, std::string_view symbol_name, void* detour);
+		~iat_hook() noexcept;
+
+		iat_hook(iat_hook&& that)            = delete;
+		iat_hook& operator=(iat_hook&& that) = delete;
+		iat_hook(const iat_hook&)            = delete;
+		iat_hook& operator=(const iat_hook&) = delete;
+
+		void enable();
+		void disable();
+
+		bool valid() const;
+		bool enabled() const;
+
+		template<typename T>
+		T get_original() const
+		{
+			return reinterpret_cast<T>(m_original);
+		}
+
+	private:
+		// Writes the slot if it still holds the comparand and returns its previous value, nullptr if it could not be unprotected.
+		void* exchange_slot(void* value, void* comparand);
+
+		std::string m_name;
+		void** m_slot;
+		void* m_original;
+		void* m_detour;
+		bool m_enabled;
+	};
+} // namespace big
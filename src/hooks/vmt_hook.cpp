@@ -1,6 +1,6 @@
 #include "vmt_hook.hpp"
 
-
+#include "hook_transaction.hpp"
 
 namespace big
 {
@@ -30,6 +30,7 @@ namespace big
 	vmt_hook::~vmt_hook()
 	{
 		disable();
+		hook_transaction::flush(this);
 	}
 
 	void vmt_hook::hook(std::size_t index, void* func)
@@ -44,14 +45,26 @@ namespace big
 
 	void vmt_hook::enable()
 	{
-		*m_object = m_new_table.get();
+		hook_transaction::execute(
+		    this,
+		    [this]
+		    {
+			    *m_object = m_new_table.get();
+		    },
+		    false);
 	}
 
 	void vmt_hook::disable()
 	{
 		if (m_object)
 		{
-			*m_object = m_original_table;
+			hook_transaction::execute(
+			    this,
+			    [this]
+			    {
+				    *m_object = m_original_table;
+			    },
+			    false);
 		}
 	}
 } // namespace big
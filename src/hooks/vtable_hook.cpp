@@ -1,5 +1,7 @@
 #include "vtable_hook.hpp"
 
+#include "hook_transaction.hpp"
+
 namespace big
 {
 	vtable_hook::vtable_hook(void** vft, std::size_t num_funcs) :
@@ -15,6 +17,7 @@ namespace big
 	vtable_hook::~vtable_hook()
 	{
 		disable();
+		hook_transaction::flush(this);
 	}
 
 	void vtable_hook::hook(std::size_t index, void* func)
@@ -29,11 +32,23 @@ namespace big
 
 	void vtable_hook::enable()
 	{
-		std::memcpy(m_table, m_hook_table.get(), m_num_funcs * sizeof(void*));
+		hook_transaction::execute(
+		    this,
+		    [this]
+		    {
+			    std::memcpy(m_table, m_hook_table.get(), m_num_funcs * sizeof(void*));
+		    },
+		    false);
 	}
 
 	void vtable_hook::disable()
 	{
-		std::memcpy(m_table, m_backup_table.get(), m_num_funcs * sizeof(void*));
+		hook_transaction::execute(
+		    this,
+		    [this]
+		    {
+			    std::memcpy(m_table, m_backup_table.get(), m_num_funcs * sizeof(void*));
+		    },
+		    false);
 	}
 } // namespace big
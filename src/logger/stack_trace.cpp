@@ -235,6 +235,7 @@ namespace big
 				if (module_info)
 				{
 					m_dump << module_info->m_path.filename().string() << "+" << HEX_TO_UPPER(addr - module_info->m_base) << " " << HEX_TO_UPPER(addr);
+					dump_function_start(module_info, addr);
 
 					// Check if symbols are loaded for this module
 					IMAGEHLP_MODULE64 mod_info{};
@@ -337,6 +338,21 @@ namespace big
 		}
 	}
 
+	void stack_trace::dump_function_start(const module_info* module_info, uintptr_t addr)
+	{
+		// Without symbols the .pdata entries still tell which function the frame is in, which is what signatures are made from.
+		const auto image     = reinterpret_cast<const uint8_t*>(module_info->m_base);
+		const auto functions = memory::pe::read_runtime_functions(image, module_info->m_image_size);
+		const auto rva       = static_cast<uint32_t>(addr - module_info->m_base);
+
+		auto entry = memory::pe::find_runtime_function(functions, rva);
+		entry      = memory::pe::primary_runtime_function(image, module_info->m_image_size, functions, entry);
+		if (entry)
+		{
+			m_dump << " (function " << module_info->m_path.filename().string() << "+" << HEX_TO_UPPER(entry->m_begin_address) << " +" << HEX_TO_UPPER(rva - entry->m_begin_address) << ")";
+		}
+	}
+
 	const stack_trace::module_info* stack_trace::get_module_by_address(uintptr_t addr) const
 	{
 		for (auto& mod_info : m_modules)
@@ -30,18 +30,21 @@ namespace big
 				const auto dos_header = reinterpret_cast<IMAGE_DOS_HEADER*>(base);
 				const auto nt_header  = reinterpret_cast<IMAGE_NT_HEADERS*>(m_base + dos_header->e_lfanew);
 
-				m_size = nt_header->OptionalHeader.SizeOfCode;
+				m_size       = nt_header->OptionalHeader.SizeOfCode;
+				m_image_size = nt_header->OptionalHeader.SizeOfImage;
 			}
 
 			std::filesystem::path m_path;
 			uintptr_t m_base;
 			size_t m_size;
+			size_t m_image_size;
 		};
 
 	private:
 		void dump_module_info();
 		void dump_registers();
 		void dump_stacktrace();
+		void dump_function_start(const module_info* module_info, uintptr_t addr);
 		bool dump_cpp_exception();
 		void grab_stacktrace();
 		const module_info* get_module_by_address(uintptr_t addr) const;
@@ -1,9 +1,17 @@
 #include "memory.hpp"
 
+#include "hooks/hook_transaction.hpp"
 #include "lua/lua_manager.hpp"
 #include "memory/module.hpp"
+#include "memory/module_registry.hpp"
+#include "memory/pattern_cache.hpp"
 #include "memory/pattern.hpp"
+#include "memory/region.hpp"
+#include "memory/rtti_index_cache.hpp"
+#include "memory/signature_generator.hpp"
+#include "memory/xref_index_cache.hpp"
 #include "rom/rom.hpp"
+#include "threads/thread_pool.hpp"
 
 // clang-format off
 #include <AsyncLogger/Logger.hpp>
@@ -112,13 +120,13 @@ namespace lua::memory
 	// Returns the base address of a specified module within the current process. Returns a pointer:is_null() == true pointer otherwise.
 	static pointer get_module_base_address_module_name(const std::string& module_name)
 	{
-		const auto mod = ::memory::module(module_name);
-		if (!mod.loaded())
+		const auto mod = ::memory::g_module_registry.get(module_name);
+		if (!mod)
 		{
 			return pointer(0);
 		}
 
-		return pointer(mod.begin().as<uintptr_t>());
+		return pointer(mod->begin().as<uintptr_t>());
 	}
 
 	static pointer get_module_base_address()
@@ -126,22 +134,52 @@ namespace lua::memory
 		return get_module_base_address_module_name(rom::g_target_module_name);
 	}
 
+	// "x", "r" and "w" flags for executable, read only and writable sections. nil scans the whole image.
+	static ::memory::section_type to_section_type(const sol::optional<std::string>& flags)
+	{
+		if (!flags)
+		{
+			return ::memory::section_type::all;
+		}
+
+		auto types = ::memory::section_type::none;
+		for (const auto flag : *flags)
+		{
+			if (flag == 'x')
+			{
+				types = types | ::memory::section_type::executable;
+			}
+			else if (flag == 'r')
+			{
+				types = types | ::memory::section_type::read_only_data;
+			}
+			else if (flag == 'w')
+			{
+				types = types | ::memory::section_type::writable_data;
+			}
+		}
+
+		return types == ::memory::section_type::none ? ::memory::section_type::all : types;
+	}
+
 	// Lua API: Function
 	// Table: memory
 	// Name: scan_pattern_from_module
 	// Param: module_name: string: module name. Example: "ntdll.dll"
 	// Param: pattern: string: byte pattern (IDA format)
+	// Param: sections: string: Optional. Only scan the sections of these kinds, any combination of "x" (code), "r" (read only data) and "w" (writable data). "x" is much faster for code patterns. Defaults to the whole module.
 	// Returns: pointer: A pointer to the found address.
-	// Scans the specified memory pattern within the target main module and returns a pointer to the found address. Returns a pointer:is_null() == true pointer otherwise.
-	static pointer scan_pattern_from_module(const std::string& module_name, const std::string& pattern)
+	// Scans the specified memory pattern within the given module and returns a pointer to the found address. Returns a pointer:is_null() == true pointer otherwise.
+	// Results are cached per module build (also across game restarts), so scanning the same pattern again is nearly free.
+	static pointer scan_pattern_from_module(const std::string& module_name, const std::string& pattern, sol::optional<std::string> sections)
 	{
-		const auto mod = ::memory::module(module_name);
-		if (!mod.loaded())
+		const auto mod = ::memory::g_module_registry.get(module_name);
+		if (!mod)
 		{
 			return pointer(0);
 		}
 
-		const auto pattern_result = mod.scan(::memory::pattern(pattern));
+		const auto pattern_result = ::memory::g_pattern_cache.scan(*mod, pattern, to_section_type(sections));
 		if (!pattern_result.has_value())
 		{
 			return pointer(0);
@@ -154,11 +192,340 @@ namespace lua::memory
 	// Table: memory
 	// Name: scan_pattern
 	// Param: pattern: string: byte pattern (IDA format)
+	// Param: sections: string: Optional. Same as in scan_pattern_from_module, defaults to the whole module.
 	// Returns: pointer: A pointer to the found address.
 	// Scans the specified memory pattern within the target main module and returns a pointer to the found address. Returns a pointer:is_null() == true pointer otherwise.
-	static pointer scan_pattern(const std::string& pattern)
+	static pointer scan_pattern(const std::string& pattern, sol::optional<std::string> sections)
+	{
+		return scan_pattern_from_module(rom::g_target_module_name, pattern, sections);
+	}
+
+	// Lua API: Function
+	// Table: memory
+	// Name: scan_patterns
+	// Param: patterns: table<string>: byte patterns (IDA format)
+	// Param: sections: string: Optional. Same as in scan_pattern_from_module, defaults to the whole module.
+	// Returns: table<pointer>: One pointer per pattern, in the same order. Not found ones are pointer:is_null() == true pointers.
+	// Scans many memory patterns within the target main module, in a single pass over it. Much faster than calling scan_pattern once per pattern.
+	static sol::table scan_patterns(sol::table patterns, sol::optional<std::string> sections, sol::this_state state)
+	{
+		std::vector<std::string> idas;
+		for (size_t i = 1; i <= patterns.size(); i++)
+		{
+			idas.push_back(patterns.get<std::string>(i));
+		}
+
+		auto results = sol::state_view(state).create_table(static_cast<int>(idas.size()));
+
+		const auto mod = ::memory::g_module_registry.get(rom::g_target_module_name);
+		if (!mod)
+		{
+			for (size_t i = 1; i <= idas.size(); i++)
+			{
+				results[i] = pointer(0);
+			}
+			return results;
+		}
+
+		const auto pattern_results = ::memory::g_pattern_cache.scan(*mod, idas, to_section_type(sections));
+		for (size_t i = 0; i < pattern_results.size(); i++)
+		{
+			results[i + 1] = pointer(pattern_results[i] ? pattern_results[i]->as<uintptr_t>() : 0);
+		}
+
+		return results;
+	}
+
+	// Lua API: Function
+	// Table: memory
+	// Name: scan_pattern_async
+	// Param: pattern: string: byte pattern (IDA format)
+	// Param: callback: function: Called on the main thread once the scan is done, with the found pointer as its only argument. The pointer is a pointer:is_null() == true pointer if nothing was found.
+	// Param: sections: string: Optional. Same as in scan_pattern_from_module, defaults to the whole module.
+	// Same as scan_pattern, but the scan runs on a background thread so that it does not block the game. The callback is not called if the mod got reloaded in the meantime.
+	// **Example Usage:**
+	// ```lua
+	// memory.scan_pattern_async("48 8B 05 ? ? ? ? 48 85 C0", function (ptr)
+	// 		if not ptr:is_null() then
+	// 			log.info(ptr:get_address())
+	// 		end
+	// end)
+	// ```
+	static void scan_pattern_async(const std::string& pattern, sol::protected_function callback, sol::optional<std::string> sections, sol::this_environment env)
+	{
+		const auto mdl = big::lua_module::this_from(env);
+		if (!mdl || !callback.valid() || !big::g_lua_manager)
+		{
+			return;
+		}
+
+		const auto request_id                            = ++big::g_lua_manager->m_async_scan_request_id;
+		mdl->m_data.m_async_scan_callbacks[request_id] = callback;
+
+		const auto scan = [mdl, request_id, pattern, types = to_section_type(sections)]
+		{
+			uintptr_t address = 0;
+			if (const auto mod = ::memory::g_module_registry.get(rom::g_target_module_name))
+			{
+				if (const auto result = ::memory::g_pattern_cache.scan(*mod, pattern, types))
+				{
+					address = result->as<uintptr_t>();
+				}
+			}
+
+			if (big::g_lua_manager)
+			{
+				std::lock_guard<std::mutex> lock(big::g_lua_manager->m_to_do_async_scan_callback_lock);
+				big::g_lua_manager->m_to_do_async_scan_callback_queue.push({mdl, request_id, address});
+			}
+		};
+
+		if (big::g_thread_pool)
+		{
+			big::g_thread_pool->push(scan);
+		}
+		else
+		{
+			scan();
+		}
+	}
+
+	static sol::table to_pointer_table(const std::vector<::memory::handle>& addresses, sol::this_state state)
+	{
+		auto result = sol::state_view(state).create_table(static_cast<int>(addresses.size()));
+		for (size_t i = 0; i < addresses.size(); i++)
+		{
+			result[i + 1] = pointer(addresses[i].as<uintptr_t>());
+		}
+		return result;
+	}
+
+	// "r", "w" and "x" flags, reading is always required.
+	static ::memory::region_protection to_region_protection(const std::string& flags)
+	{
+		auto protection = ::memory::region_protection::read;
+		for (const auto flag : flags)
+		{
+			if (flag == 'w')
+			{
+				protection = protection | ::memory::region_protection::write;
+			}
+			else if (flag == 'x')
+			{
+				protection = protection | ::memory::region_protection::execute;
+			}
+		}
+
+		return protection;
+	}
+
+	// Lua API: Function
+	// Table: memory
+	// Name: scan_pattern_regions
+	// Param: pattern: string: byte pattern (IDA format)
+	// Param: protection: string: Optional. Protection every scanned region needs, any combination of "r", "w" and "x". Defaults to "r". Use "rw" for heap objects, "rx" for code.
+	// Param: max_results: integer: Optional. Maximum number of returned matches, defaults to 1000.
+	// Returns: table<pointer>: Every match, sorted by address.
+	// Scans all the committed memory of the process, not only module images: heap allocated objects, JIT code, etc.
+	// The regions are scanned in parallel, this is still a lot of memory though, prefer scan_pattern when the target lives in the game module.
+	static sol::table scan_pattern_regions(const std::string& pattern, sol::optional<std::string> protection, sol::optional<size_t> max_results, sol::this_state state)
 	{
-		return scan_pattern_from_module(rom::g_target_module_name, pattern);
+		::memory::region_filter filter;
+		filter.m_required = to_region_protection(protection.value_or("r"));
+
+		const ::memory::pattern sig(pattern);
+		std::vector<::memory::handle> matches;
+		::memory::scan_regions(sig.view(), matches, filter, max_results.value_or(1'000));
+
+		return to_pointer_table(matches, state);
+	}
+
+	// Loaded module containing the address, nullptr if it is not inside of one.
+	static std::shared_ptr<const ::memory::module> module_from_address(uintptr_t address)
+	{
+		HMODULE module_handle{};
+		if (!GetModuleHandleExA(GET_MODULE_HANDLE_EX_FLAG_FROM_ADDRESS | GET_MODULE_HANDLE_EX_FLAG_UNCHANGED_REFCOUNT,
+		                        reinterpret_cast<LPCSTR>(address),
+		                        &module_handle))
+		{
+			return nullptr;
+		}
+
+		return ::memory::g_module_registry.get(module_handle);
+	}
+
+	// Lua API: Function
+	// Table: memory
+	// Name: make_signature
+	// Param: ptr: pointer: Address inside the code of a loaded module, usually the start of a function.
+	// Param: opts: table: Optional. `max_length` (integer, defaults to 64): longest signature tried, in bytes.
+	// Returns: string or nil: The shortest IDA signature only matching at ptr among the executable sections of its module, nil if there is none within max_length bytes.
+	// RIP-relative displacements, call / jmp targets and relocated addresses are wildcarded, so the signature has good chances to survive a game update.
+	// **Example Usage:**
+	// ```lua
+	// local sig = memory.make_signature(memory.scan_pattern("48 89 5C 24 08 57 48 83 EC 20 8B 05"))
+	// log.info(sig)
+	// ```
+	static sol::object make_signature(pointer& ptr, sol::optional<sol::table> opts, sol::this_state state)
+	{
+		const auto mod = module_from_address(ptr.get_address());
+		if (!mod)
+		{
+			return sol::nil;
+		}
+
+		::memory::signature_options options;
+		if (opts)
+		{
+			options.m_max_length = opts->get_or<size_t>("max_length", options.m_max_length);
+		}
+
+		const auto signature = ::memory::make_signature(*mod, ::memory::handle(ptr.get_address()), options);
+		if (!signature)
+		{
+			return sol::nil;
+		}
+
+		return sol::make_object(state, *signature);
+	}
+
+	// Lua API: Function
+	// Table: memory
+	// Name: get_function_bounds
+	// Param: ptr: pointer: Address inside the code of a loaded module.
+	// Returns: pointer, pointer, pointer or nil: Entry point of the function containing ptr, then start and end (exclusive) of the fragment of that function containing ptr, from the exception directory of the module. nil for leaf functions, which have no entry there.
+	// The fragment is the whole function unless the compiler split it, cold code can then be far away from the entry point.
+	// Useful to go from a pattern match or a caller address back to the start of its function.
+	// **Example Usage:**
+	// ```lua
+	// local entry, start, finish = memory.get_function_bounds(memory.find_callers(func)[1])
+	// ```
+	static std::tuple<sol::object, sol::object, sol::object> get_function_bounds(pointer& ptr, sol::this_state state)
+	{
+		const auto mod = module_from_address(ptr.get_address());
+		if (!mod)
+		{
+			return {sol::nil, sol::nil, sol::nil};
+		}
+
+		const auto function = mod->function_containing(::memory::handle(ptr.get_address()));
+		if (!function)
+		{
+			return {sol::nil, sol::nil, sol::nil};
+		}
+
+		return {sol::make_object(state, pointer(function->m_entry.as<uintptr_t>())),
+		        sol::make_object(state, pointer(function->m_fragment.begin().as<uintptr_t>())),
+		        sol::make_object(state, pointer(function->m_fragment.end().as<uintptr_t>()))};
+	}
+
+	// Lua API: Function
+	// Table: memory
+	// Name: build_xref_index
+	// Param: module_name: string: Optional. Module name, the target main module if not given.
+	// Returns: boolean: true if the module is loaded and got indexed.
+	// Indexes every call, jmp and RIP-relative operand of the executable sections of the module, so that memory.find_callers and memory.find_xrefs work on it.
+	// Takes a while the first time a game build is indexed, the index is then cached on disk.
+	static bool build_xref_index(sol::optional<std::string> module_name)
+	{
+		const auto mod = ::memory::g_module_registry.get(module_name.value_or(rom::g_target_module_name));
+		if (!mod)
+		{
+			return false;
+		}
+
+		return ::memory::g_xref_index_cache.get(*mod) != nullptr;
+	}
+
+	// Lua API: Function
+	// Table: memory
+	// Name: find_callers
+	// Param: function_ptr: pointer: Start of the function.
+	// Returns: table<pointer>: Address of each call instruction targeting the function. Empty if the module of the function was not indexed with memory.build_xref_index.
+	static sol::table find_callers(pointer& function_ptr, sol::this_state state)
+	{
+		const ::memory::handle target(function_ptr.get_address());
+		const auto index = ::memory::g_xref_index_cache.find(target);
+		if (!index)
+		{
+			return sol::state_view(state).create_table();
+		}
+
+		return to_pointer_table(index->callers(target), state);
+	}
+
+	// Lua API: Function
+	// Table: memory
+	// Name: find_xrefs
+	// Param: target_ptr: pointer: Function, global or any other address of the module.
+	// Returns: table<pointer>: Address of each instruction referencing the target: calls, jumps and RIP-relative operands. Empty if the module of the target was not indexed with memory.build_xref_index.
+	static sol::table find_xrefs(pointer& target_ptr, sol::this_state state)
+	{
+		const ::memory::handle target(target_ptr.get_address());
+		const auto index = ::memory::g_xref_index_cache.find(target);
+		if (!index)
+		{
+			return sol::state_view(state).create_table();
+		}
+
+		return to_pointer_table(index->references(target), state);
+	}
+
+	// Lua API: Function
+	// Table: memory
+	// Name: find_string_xrefs
+	// Param: str: string: Exact content of a string literal of the module, narrow or UTF-16.
+	// Param: module_name: string: Optional. Module name, the target main module if not given.
+	// Returns: table<pointer>: Address of each instruction referencing the string through a RIP-relative operand, usually a lea. Empty if the string is not found.
+	// Finding the function that uses a known (debug) string tends to survive game updates far better than a byte pattern.
+	// The first call builds the string and xref indices of the module, see memory.build_xref_index.
+	// **Example Usage:**
+	// ```lua
+	// local refs = memory.find_string_xrefs("Failed to load save file")
+	// if #refs > 0 then
+	// 		log.info(refs[1]:get_address())
+	// end
+	// ```
+	static sol::table find_string_xrefs(const std::string& str, sol::optional<std::string> module_name, sol::this_state state)
+	{
+		const auto mod = ::memory::g_module_registry.get(module_name.value_or(rom::g_target_module_name));
+		if (!mod)
+		{
+			return sol::state_view(state).create_table();
+		}
+
+		return to_pointer_table(::memory::g_xref_index_cache.string_references(*mod, str), state);
+	}
+
+	// Lua API: Function
+	// Table: memory
+	// Name: find_vtable
+	// Param: class_name: string: Name of the class as given by typeid: "class Foo", "struct ns::Bar", or the mangled RTTI name (".?AVFoo@@"), needed for templates.
+	// Param: module_name: string: Optional. Module name, the target main module if not given.
+	// Returns: pointer or nil: The vtable of the class (its first function slot), nil if the module has no RTTI for it.
+	// The first call walks the RTTI of the module once, then every lookup is a binary search. The index is cached on disk per game build.
+	// **Example Usage:**
+	// ```lua
+	// local vtable = memory.find_vtable("class ns::Foo")
+	// if vtable then
+	// 		local first_function = vtable:deref()
+	// end
+	// ```
+	static sol::object find_vtable(const std::string& class_name, sol::optional<std::string> module_name, sol::this_state state)
+	{
+		const auto mod = ::memory::g_module_registry.get(module_name.value_or(rom::g_target_module_name));
+		if (!mod)
+		{
+			return sol::nil;
+		}
+
+		const auto vtable = ::memory::g_rtti_index_cache.find_vtable(*mod, class_name);
+		if (!vtable)
+		{
+			return sol::nil;
+		}
+
+		return sol::make_object(state, pointer(vtable->as<uintptr_t>()));
 	}
 
 	// Lua API: Function
@@ -255,6 +622,185 @@ namespace lua::memory
 		}
 	}
 
+	static std::optional<::memory::value_type> to_value_type(const std::string& type)
+	{
+		static const ankerl::unordered_dense::map<std::string, ::memory::value_type> types = {
+		    {"u8", ::memory::value_type::u8},
+		    {"u16", ::memory::value_type::u16},
+		    {"u32", ::memory::value_type::u32},
+		    {"u64", ::memory::value_type::u64},
+		    {"i8", ::memory::value_type::i8},
+		    {"i16", ::memory::value_type::i16},
+		    {"i32", ::memory::value_type::i32},
+		    {"i64", ::memory::value_type::i64},
+		    {"float", ::memory::value_type::f32},
+		    {"double", ::memory::value_type::f64},
+		};
+
+		const auto it = types.find(type);
+		if (it == types.end())
+		{
+			LOG(ERROR) << "Unknown value_scanner type: " << type;
+			return std::nullopt;
+		}
+
+		return it->second;
+	}
+
+	static std::optional<::memory::value_compare> to_value_compare(const std::string& compare)
+	{
+		static const ankerl::unordered_dense::map<std::string, ::memory::value_compare> compares = {
+		    {"exact", ::memory::value_compare::exact},
+		    {"range", ::memory::value_compare::range},
+		    {"changed", ::memory::value_compare::changed},
+		    {"unchanged", ::memory::value_compare::unchanged},
+		    {"increased", ::memory::value_compare::increased},
+		    {"decreased", ::memory::value_compare::decreased},
+		};
+
+		const auto it = compares.find(compare);
+		if (it == compares.end())
+		{
+			LOG(ERROR) << "Unknown value_scanner compare: " << compare;
+			return std::nullopt;
+		}
+
+		return it->second;
+	}
+
+	// Lua integers are passed as is, going through a double would round the 64 bit ones.
+	static std::optional<::memory::scan_value> to_scan_value(const sol::object& value)
+	{
+		if (value.get_type() != sol::type::number)
+		{
+			LOG(ERROR) << "value_scanner values must be numbers.";
+			return std::nullopt;
+		}
+
+#if LUA_VERSION_NUM >= 503
+		const auto state = value.lua_state();
+		value.push(state);
+		const bool is_integer = lua_isinteger(state, -1);
+		lua_pop(state, 1);
+		if (is_integer)
+		{
+			return value.as<int64_t>();
+		}
+#endif
+
+		return value.as<double>();
+	}
+
+	static std::optional<::memory::value_condition> to_value_condition(::memory::value_compare compare, const sol::object& value, const sol::object& max_or_tolerance)
+	{
+		::memory::value_condition condition;
+		condition.m_compare = compare;
+
+		if (value.valid())
+		{
+			const auto scan_value = to_scan_value(value);
+			if (!scan_value)
+			{
+				return std::nullopt;
+			}
+			condition.m_value = *scan_value;
+		}
+
+		const bool is_range = compare == ::memory::value_compare::range;
+		if (max_or_tolerance.valid())
+		{
+			const auto scan_value = to_scan_value(max_or_tolerance);
+			if (!scan_value)
+			{
+				return std::nullopt;
+			}
+			(is_range ? condition.m_max : condition.m_tolerance) = *scan_value;
+		}
+		else if (is_range)
+		{
+			condition.m_max = condition.m_value;
+		}
+
+		return condition;
+	}
+
+	value_scanner::value_scanner(const std::string& type)
+	{
+		if (const auto value_type = to_value_type(type))
+		{
+			m_scanner.emplace(*value_type);
+		}
+	}
+
+	value_scanner::value_scanner(const std::string& type, const std::string& protection)
+	{
+		if (const auto value_type = to_value_type(type))
+		{
+			m_scanner.emplace(*value_type, ::memory::region_filter{to_region_protection(protection)});
+		}
+	}
+
+	size_t value_scanner::first_scan(const std::string& compare, sol::object value, sol::object max_or_tolerance)
+	{
+		const auto value_compare = to_value_compare(compare);
+		if (!m_scanner || !value_compare)
+		{
+			return 0;
+		}
+
+		if (value_compare != ::memory::value_compare::exact && value_compare != ::memory::value_compare::range)
+		{
+			LOG(ERROR) << "value_scanner:first_scan only supports exact and range, there is no previous value to compare to.";
+			return 0;
+		}
+
+		const auto condition = to_value_condition(*value_compare, value, max_or_tolerance);
+		if (!condition)
+		{
+			return 0;
+		}
+
+		return m_scanner->first_scan(*condition);
+	}
+
+	size_t value_scanner::next_scan(const std::string& compare, sol::object value, sol::object max_or_tolerance)
+	{
+		if (!m_scanner)
+		{
+			return 0;
+		}
+
+		const auto value_compare = to_value_compare(compare);
+		if (!value_compare)
+		{
+			return m_scanner->count();
+		}
+
+		const auto condition = to_value_condition(*value_compare, value, max_or_tolerance);
+		if (!condition)
+		{
+			return m_scanner->count();
+		}
+
+		return m_scanner->next_scan(*condition);
+	}
+
+	size_t value_scanner::count() const
+	{
+		return m_scanner ? m_scanner->count() : 0;
+	}
+
+	sol::table value_scanner::results(sol::optional<size_t> max_count, sol::this_state state) const
+	{
+		std::vector<::memory::handle> results;
+		for (const auto address : m_scanner ? m_scanner->candidates(max_count.value_or(100)) : std::vector<uintptr_t>{})
+		{
+			results.emplace_back(address);
+		}
+
+		return to_pointer_table(results, state);
+	}
+
 	static bool pre_callback(const runtime_func_t::parameters_t* params, const uint8_t param_count, runtime_func_t::return_value_t* return_value, const uintptr_t target_func_ptr)
 	{
 		const auto& dyn_hook = big::g_lua_manager->m_target_func_ptr_to_dynamic_hook[target_func_ptr];
@@ -351,6 +897,8 @@ namespace lua::memory
 
 		if (need_hook)
 		{
+			big::g_lua_manager->update_dynamic_hook_dispatch(target_func_ptr);
+
 			std::shared_ptr<runtime_func_t> runtime_func;
 
 			if (!big::g_lua_manager->m_target_func_ptr_to_dynamic_hook.contains(target_func_ptr))
@@ -467,6 +1015,7 @@ namespace lua::memory
 		const auto target_func_ptr = target_func_ptr_obj.get_address();
 
 		mdl->m_data.m_dynamic_hook_mid_callbacks[target_func_ptr] = lua_mid_callback;
+		big::g_lua_manager->update_dynamic_hook_dispatch(target_func_ptr);
 
 		auto parse_table_to_string = [](const sol::table& table, std::vector<std::string>& target_vector)
 		{
@@ -540,6 +1089,30 @@ namespace lua::memory
 		}
 	}
 
+	// Lua API: Function
+	// Table: memory
+	// Name: transaction
+	// Param: func: function: Called right away, with no arguments.
+	// The hooks and patches enabled or disabled inside func (dynamic hooks, memory patches) are queued, then applied together once it returns, with the game threads suspended once for all of them instead of once per hook.
+	// Until func returns, the queued changes are not visible yet: reading the patched memory still gives the old bytes. An error in func is logged and what it queued is still applied.
+	// **Example Usage:**
+	// ```lua
+	// memory.transaction(function ()
+	// 		memory.dynamic_hook_enable(first_hook)
+	// 		memory.dynamic_hook_enable(second_hook)
+	// end)
+	// ```
+	static void transaction(sol::protected_function func)
+	{
+		big::hook_transaction transaction;
+
+		const auto result = func();
+		if (!result.valid())
+		{
+			LOG(ERROR) << "memory.transaction: " << result.get<sol::error>().what();
+		}
+	}
+
 	static std::string get_jitted_lua_func_global_name(uintptr_t function_to_call_ptr)
 	{
 		return std::format("__dynamic_call_{}", function_to_call_ptr);
@@ -959,6 +1532,12 @@ namespace lua::memory
 		pointer_ut["deref"]        = &pointer::deref;
 		pointer_ut["get_address"]  = &pointer::get_address;
 
+		auto value_scanner_ut          = ns.new_usertype<value_scanner>("value_scanner", sol::constructors<value_scanner(const std::string&), value_scanner(const std::string&, const std::string&)>());
+		value_scanner_ut["first_scan"] = &value_scanner::first_scan;
+		value_scanner_ut["next_scan"]  = &value_scanner::next_scan;
+		value_scanner_ut["count"]      = &value_scanner::count;
+		value_scanner_ut["results"]    = &value_scanner::results;
+
 		auto patch_ut       = ns.new_usertype<big::lua_patch>("patch", sol::no_constructor);
 		patch_ut["apply"]   = &big::lua_patch::apply;
 		patch_ut["restore"] = &big::lua_patch::restore;
@@ -967,6 +1546,19 @@ namespace lua::memory
 
 		ns["scan_pattern_from_module"] = scan_pattern_from_module;
 		ns["scan_pattern"]             = scan_pattern;
+		ns["scan_patterns"]            = scan_patterns;
+		ns["scan_pattern_async"]       = scan_pattern_async;
+		ns["scan_pattern_regions"]     = scan_pattern_regions;
+
+		ns["make_signature"]      = make_signature;
+		ns["get_function_bounds"] = get_function_bounds;
+
+		ns["build_xref_index"]  = build_xref_index;
+		ns["find_callers"]      = find_callers;
+		ns["find_xrefs"]        = find_xrefs;
+		ns["find_string_xrefs"] = find_string_xrefs;
+
+		ns["find_vtable"] = find_vtable;
 
 		ns["allocate"] = allocate;
 		ns["free"]     = lua_memory_free;
@@ -976,6 +1568,7 @@ namespace lua::memory
 		ns["dynamic_hook_mid"]        = dynamic_hook_mid;
 		ns["dynamic_hook_enable"]     = dynamic_hook_enable;
 		ns["dynamic_hook_disable"]    = dynamic_hook_disable;
+		ns["transaction"]             = transaction;
 		ns["dynamic_call"]            = dynamic_call;
 		ns["resolve_pointer_to_type"] = resolve_pointer_to_type;
 
@@ -1,6 +1,7 @@
 #pragma once
 #include "lua/lua_module.hpp"
 #include "memory/byte_patch.hpp"
+#include "memory/value_scanner.hpp"
 
 namespace lua::memory
 {
@@ -276,5 +277,67 @@ namespace lua::memory
 		void set(sol::object new_val, sol::this_state state_);
 	};
 
+	// Lua API: Class
+	// Name: value_scanner
+	// Class for finding dynamic addresses, such as a health float, by their value: a first scan over the process memory, then next scans narrowing the candidates down as the value changes in game.
+	// **Example Usage:**
+	// ```lua
+	// local scanner = memory.value_scanner("float")
+	// scanner:first_scan("exact", 100, 0.01)
+	// -- take some damage in game, then
+	// scanner:next_scan("decreased")
+	// for _, ptr in ipairs(scanner:results(10)) do
+	// 		log.info(ptr:get_address())
+	// end
+	// ```
+
+	class value_scanner
+	{
+		// Empty when the type is unknown, every scan then finds nothing.
+		std::optional<::memory::value_scanner> m_scanner;
+
+	public:
+		// Lua API: Constructor
+		// Class: value_scanner
+		// Param: type: string: Type of the value: "u8", "u16", "u32", "u64", "i8", "i16", "i32", "i64", "float" or "double". An unknown type logs an error and the scanner never finds anything.
+		// Param: protection: string: Optional. Protection every scanned region needs, any combination of "r", "w" and "x". Defaults to "rw".
+		// Returns a value_scanner instance without any candidate.
+		explicit value_scanner(const std::string& type);
+		explicit value_scanner(const std::string& type, const std::string& protection);
+
+		// Lua API: Function
+		// Class: value_scanner
+		// Name: first_scan
+		// Param: compare: string: "exact" or "range".
+		// Param: value: number: Value to look for, lower bound for "range". Integers are exact, even the 64 bit ones a float can't hold.
+		// Param: max_or_tolerance: number: Optional. Upper bound for "range", allowed difference for an "exact" float / double scan.
+		// Returns: integer: Candidate count.
+		// Scans the whole process memory, replacing the current candidates.
+		size_t first_scan(const std::string& compare, sol::object value, sol::object max_or_tolerance);
+
+		// Lua API: Function
+		// Class: value_scanner
+		// Name: next_scan
+		// Param: compare: string: "exact", "range", "changed", "unchanged", "increased" or "decreased". The last 4 compare to the value at the previous scan.
+		// Param: value: number: Optional. Only used by "exact" and "range".
+		// Param: max_or_tolerance: number: Optional. Upper bound for "range", allowed difference for an "exact" float / double scan.
+		// Returns: integer: Candidate count.
+		// Only keeps the candidates matching the comparison.
+		size_t next_scan(const std::string& compare, sol::object value, sol::object max_or_tolerance);
+
+		// Lua API: Function
+		// Class: value_scanner
+		// Name: count
+		// Returns: integer: Candidate count.
+		size_t count() const;
+
+		// Lua API: Function
+		// Class: value_scanner
+		// Name: results
+		// Param: max_count: integer: Optional. Defaults to 100.
+		// Returns: table<pointer>: The first candidates, sorted by address.
+		sol::table results(sol::optional<size_t> max_count, sol::this_state state) const;
+	};
+
 	void bind(sol::table& state);
 } // namespace lua::memory
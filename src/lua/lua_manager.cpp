@@ -12,6 +12,9 @@
 #include "directory_watcher/directory_watcher.hpp"
 #include "file_manager/file_manager.hpp"
 #include "logger/logger.hpp"
+#include "memory/pattern_cache.hpp"
+#include "memory/rtti_index_cache.hpp"
+#include "memory/xref_index_cache.hpp"
 #include "string/string.hpp"
 
 namespace big
@@ -136,6 +139,11 @@ namespace big
 	    m_get_env_for_module(get_env_for_module)
 	{
 		g_lua_manager = this;
+
+		const auto scan_cache_folder = m_plugins_data_folder.get_path() / (rom::g_project_name + "-scan_cache");
+		::memory::g_pattern_cache.set_folder(scan_cache_folder);
+		::memory::g_xref_index_cache.set_folder(scan_cache_folder);
+		::memory::g_rtti_index_cache.set_folder(scan_cache_folder);
 	}
 
 	lua_manager::~lua_manager()
@@ -144,6 +152,8 @@ namespace big
 
 		unload_all_modules();
 
+		::memory::g_pattern_cache.flush();
+
 		g_lua_manager = nullptr;
 	}
 
@@ -229,6 +239,7 @@ namespace big
 				auto& mod = m_to_reload_queue.front();
 
 				mod->cleanup();
+				rebuild_dynamic_hook_dispatch();
 				mod->load_and_call_plugin(m_state);
 
 				m_to_reload_queue.pop();
@@ -238,6 +249,8 @@ namespace big
 			{
 				m_to_reload_duplicate_checker.clear();
 				m_to_reload_duplicate_checker_2.clear();
+
+				::memory::g_pattern_cache.flush();
 			}
 		}
 		{
@@ -262,6 +275,48 @@ namespace big
 				m_to_do_file_callback_queue.pop();
 			}
 		}
+		{
+			// Swapped out so that callbacks can start new async scans without deadlocking on the queue lock.
+			decltype(m_to_do_async_scan_callback_queue) finished_scans;
+			{
+				std::lock_guard<std::mutex> lock(m_to_do_async_scan_callback_lock);
+				std::swap(finished_scans, m_to_do_async_scan_callback_queue);
+			}
+
+			if (finished_scans.size())
+			{
+				::memory::g_pattern_cache.flush();
+			}
+
+			while (finished_scans.size())
+			{
+				std::scoped_lock l(m_module_lock);
+
+				const auto [mdl, request_id, address] = finished_scans.front();
+				finished_scans.pop();
+
+				// The module may have been unloaded while the scan was running.
+				const auto is_loaded = std::ranges::any_of(m_modules,
+				                                           [mdl](const std::unique_ptr<lua_module>& loaded_module)
+				                                           {
+					                                           return loaded_module.get() == mdl;
+				                                           });
+				if (!is_loaded)
+				{
+					continue;
+				}
+
+				const auto callback = mdl->m_data.m_async_scan_callbacks.find(request_id);
+				if (callback == mdl->m_data.m_async_scan_callbacks.end())
+				{
+					continue;
+				}
+
+				const auto cb = std::move(callback->second);
+				mdl->m_data.m_async_scan_callbacks.erase(callback);
+				cb(lua::memory::pointer(address));
+			}
+		}
 	}
 
 	static std::optional<sol::environment> get_env_from_lua_state(lua_State* L)
@@ -548,32 +603,40 @@ namespace big
 
 	bool lua_manager::dynamic_hook_pre_callbacks(const uintptr_t target_func_ptr, lua::memory::type_info_t return_type, lua::memory::runtime_func_t::return_value_t* return_value, std::vector<lua::memory::type_info_t> param_types, const lua::memory::runtime_func_t::parameters_t* params, const uint8_t param_count)
 	{
+		// Lock free check so that targets without callbacks never wait on the lua state.
+		if (!m_dynamic_hook_dispatch.load()->m_pre.contains(target_func_ptr))
+		{
+			return true;
+		}
+
+		// The lua state is still single threaded.
 		std::scoped_lock guard(m_module_lock);
 
+		// Loaded again under the lock, the callbacks of a module cleaned up since the check must not run.
+		const auto dispatch = m_dynamic_hook_dispatch.load();
+		const auto it       = dispatch->m_pre.find(target_func_ptr);
+		if (it == dispatch->m_pre.end())
+		{
+			return true;
+		}
+
 		bool call_orig_if_true = true;
 
-		for (const auto& module : m_modules)
+		sol::object return_value_obj = to_lua(return_value, return_type);
+		std::vector<sol::object> args;
+		for (uint8_t i = 0; i < param_count; i++)
 		{
-			const auto it = module->m_data.m_dynamic_hook_pre_callbacks.find(target_func_ptr);
-			if (it != module->m_data.m_dynamic_hook_pre_callbacks.end())
-			{
-				sol::object return_value_obj = to_lua(return_value, return_type);
-				std::vector<sol::object> args;
-				for (uint8_t i = 0; i < param_count; i++)
-				{
-					args.push_back(to_lua(params, i, param_types));
-				}
+			args.push_back(to_lua(params, i, param_types));
+		}
 
-				for (const auto& cb : it->second)
-				{
-					const auto new_call_orig_if_true = cb(return_value_obj, sol::as_args(args));
+		for (const auto& cb : *it->second)
+		{
+			const auto new_call_orig_if_true = cb(return_value_obj, sol::as_args(args));
 
-					if (call_orig_if_true && new_call_orig_if_true.valid() && new_call_orig_if_true.get_type() == sol::type::boolean
-					    && new_call_orig_if_true.get<bool>() == false)
-					{
-						call_orig_if_true = false;
-					}
-				}
+			if (call_orig_if_true && new_call_orig_if_true.valid() && new_call_orig_if_true.get_type() == sol::type::boolean
+			    && new_call_orig_if_true.get<bool>() == false)
+			{
+				call_orig_if_true = false;
 			}
 		}
 
@@ -582,54 +645,167 @@ namespace big
 
 	void lua_manager::dynamic_hook_post_callbacks(const uintptr_t target_func_ptr, lua::memory::type_info_t return_type, lua::memory::runtime_func_t::return_value_t* return_value, std::vector<lua::memory::type_info_t> param_types, const lua::memory::runtime_func_t::parameters_t* params, const uint8_t param_count)
 	{
+		if (!m_dynamic_hook_dispatch.load()->m_post.contains(target_func_ptr))
+		{
+			return;
+		}
+
 		std::scoped_lock guard(m_module_lock);
 
-		for (const auto& module : m_modules)
+		const auto dispatch = m_dynamic_hook_dispatch.load();
+		const auto it       = dispatch->m_post.find(target_func_ptr);
+		if (it == dispatch->m_post.end())
 		{
-			const auto it = module->m_data.m_dynamic_hook_post_callbacks.find(target_func_ptr);
-			if (it != module->m_data.m_dynamic_hook_post_callbacks.end())
-			{
-				sol::object return_value_obj = to_lua(return_value, return_type);
-				std::vector<sol::object> args;
-				for (uint8_t i = 0; i < param_count; i++)
-				{
-					args.push_back(to_lua(params, i, param_types));
-				}
+			return;
+		}
 
-				for (const auto& cb : it->second)
-				{
-					cb(return_value_obj, sol::as_args(args));
-				}
-			}
+		sol::object return_value_obj = to_lua(return_value, return_type);
+		std::vector<sol::object> args;
+		for (uint8_t i = 0; i < param_count; i++)
+		{
+			args.push_back(to_lua(params, i, param_types));
+		}
+
+		for (const auto& cb : *it->second)
+		{
+			cb(return_value_obj, sol::as_args(args));
 		}
 	}
 
 	uintptr_t lua_manager::dynamic_hook_mid_callbacks(const uintptr_t target_func_ptr, sol::table& args)
 	{
+		if (!m_dynamic_hook_dispatch.load()->m_mid.contains(target_func_ptr))
+		{
+			return 0;
+		}
+
 		std::scoped_lock guard(m_module_lock);
 
+		const auto dispatch = m_dynamic_hook_dispatch.load();
+		const auto it       = dispatch->m_mid.find(target_func_ptr);
+		if (it == dispatch->m_mid.end())
+		{
+			return 0;
+		}
+
 		uintptr_t restore_address = 0;
 
-		for (const auto& module : m_modules)
+		for (const auto& cb : *it->second)
 		{
-			const auto it = module->m_data.m_dynamic_hook_mid_callbacks.find(target_func_ptr);
-			if (it != module->m_data.m_dynamic_hook_mid_callbacks.end())
-			{
-				const auto new_restore_address = it->second(args);
+			const auto new_restore_address = cb(args);
 
-				if (!restore_address && new_restore_address.valid() && new_restore_address.get_type() == sol::type::userdata)
+			if (!restore_address && new_restore_address.valid() && new_restore_address.get_type() == sol::type::userdata)
+			{
+				lua::memory::pointer address_ptr = new_restore_address.get<lua::memory::pointer>();
+				if (address_ptr.is_valid())
 				{
-					lua::memory::pointer address_ptr = new_restore_address.get<lua::memory::pointer>();
-					if (address_ptr.is_valid())
-					{
-						restore_address = address_ptr.get_address();
-					}
+					restore_address = address_ptr.get_address();
 				}
 			}
 		}
 		return restore_address;
 	}
 
+	template<typename T>
+	static lua_manager::dynamic_hook_callbacks_t collect_dynamic_hook_callbacks(const std::vector<std::unique_ptr<lua_module>>& modules, const uintptr_t target_func_ptr, T lua_module::lua_module_data::*callbacks)
+	{
+		std::vector<sol::protected_function> result;
+		for (const auto& module : modules)
+		{
+			const auto& module_callbacks = module->m_data.*callbacks;
+			const auto it                = module_callbacks.find(target_func_ptr);
+			if (it == module_callbacks.end())
+			{
+				continue;
+			}
+
+			if constexpr (std::is_same_v<typename T::mapped_type, sol::protected_function>)
+			{
+				result.push_back(it->second);
+			}
+			else
+			{
+				result.insert(result.end(), it->second.begin(), it->second.end());
+			}
+		}
+
+		if (result.empty())
+		{
+			return nullptr;
+		}
+
+		return std::make_shared<const std::vector<sol::protected_function>>(std::move(result));
+	}
+
+	static void set_dynamic_hook_callbacks(ankerl::unordered_dense::map<uintptr_t, lua_manager::dynamic_hook_callbacks_t>& dispatch, const uintptr_t target_func_ptr, lua_manager::dynamic_hook_callbacks_t callbacks)
+	{
+		if (callbacks)
+		{
+			dispatch[target_func_ptr] = std::move(callbacks);
+		}
+		else
+		{
+			dispatch.erase(target_func_ptr);
+		}
+	}
+
+	void lua_manager::update_dynamic_hook_dispatch(const uintptr_t target_func_ptr)
+	{
+		std::scoped_lock guard(m_module_lock);
+
+		// Only the tables of this target are rebuilt, the others are shared with the previous dispatch.
+		auto dispatch = std::make_shared<dynamic_hook_dispatch_t>(*m_dynamic_hook_dispatch.load());
+		set_dynamic_hook_callbacks(dispatch->m_pre, target_func_ptr, collect_dynamic_hook_callbacks(m_modules, target_func_ptr, &lua_module::lua_module_data::m_dynamic_hook_pre_callbacks));
+		set_dynamic_hook_callbacks(dispatch->m_post, target_func_ptr, collect_dynamic_hook_callbacks(m_modules, target_func_ptr, &lua_module::lua_module_data::m_dynamic_hook_post_callbacks));
+		set_dynamic_hook_callbacks(dispatch->m_mid, target_func_ptr, collect_dynamic_hook_callbacks(m_modules, target_func_ptr, &lua_module::lua_module_data::m_dynamic_hook_mid_callbacks));
+
+		publish_dynamic_hook_dispatch(std::move(dispatch));
+	}
+
+	void lua_manager::rebuild_dynamic_hook_dispatch()
+	{
+		std::scoped_lock guard(m_module_lock);
+
+		ankerl::unordered_dense::set<uintptr_t> targets;
+		for (const auto& module : m_modules)
+		{
+			for (const auto& [target_func_ptr, _] : module->m_data.m_dynamic_hook_pre_callbacks)
+			{
+				targets.insert(target_func_ptr);
+			}
+			for (const auto& [target_func_ptr, _] : module->m_data.m_dynamic_hook_post_callbacks)
+			{
+				targets.insert(target_func_ptr);
+			}
+			for (const auto& [target_func_ptr, _] : module->m_data.m_dynamic_hook_mid_callbacks)
+			{
+				targets.insert(target_func_ptr);
+			}
+		}
+
+		auto dispatch = std::make_shared<dynamic_hook_dispatch_t>();
+		for (const auto target_func_ptr : targets)
+		{
+			set_dynamic_hook_callbacks(dispatch->m_pre, target_func_ptr, collect_dynamic_hook_callbacks(m_modules, target_func_ptr, &lua_module::lua_module_data::m_dynamic_hook_pre_callbacks));
+			set_dynamic_hook_callbacks(dispatch->m_post, target_func_ptr, collect_dynamic_hook_callbacks(m_modules, target_func_ptr, &lua_module::lua_module_data::m_dynamic_hook_post_callbacks));
+			set_dynamic_hook_callbacks(dispatch->m_mid, target_func_ptr, collect_dynamic_hook_callbacks(m_modules, target_func_ptr, &lua_module::lua_module_data::m_dynamic_hook_mid_callbacks));
+		}
+
+		publish_dynamic_hook_dispatch(std::move(dispatch));
+	}
+
+	void lua_manager::publish_dynamic_hook_dispatch(std::shared_ptr<const dynamic_hook_dispatch_t> dispatch)
+	{
+		m_retired_dynamic_hook_dispatch.push_back(m_dynamic_hook_dispatch.exchange(std::move(dispatch)));
+
+		// Unpublished, so a table only referenced from here can't be picked up by a hooked function anymore.
+		std::erase_if(m_retired_dynamic_hook_dispatch,
+		              [](const auto& retired)
+		              {
+			              return retired.use_count() == 1;
+		              });
+	}
+
 	sol::object lua_manager::to_lua(const lua::memory::runtime_func_t::parameters_t* params, const uint8_t i, const std::vector<lua::memory::type_info_t>& param_types)
 	{
 		if (param_types[i].m_val == lua::memory::type_info_t::none_)
@@ -699,6 +875,8 @@ namespace big
 		              {
 			              return module_guid == module->guid();
 		              });
+
+		rebuild_dynamic_hook_dispatch();
 	}
 
 	bool lua_manager::module_exists(const std::string& module_guid)
@@ -726,5 +904,7 @@ namespace big
 		std::scoped_lock guard(m_module_lock);
 
 		m_modules.clear();
+
+		rebuild_dynamic_hook_dispatch();
 	}
 } // namespace big
@@ -2,10 +2,12 @@
 #include "bindings/runtime_func_t.hpp"
 #include "load_module_result.hpp"
 #include "lua_module.hpp"
+#include "memory/pattern_cache.hpp"
 #include "module_info.hpp"
 #include "rom/rom.hpp"
 
 #include <ankerl/unordered_dense.h>
+#include <atomic>
 #include <file_manager/folder.hpp>
 #include <lua/bindings/imgui_window.hpp>
 #include <mutex>
@@ -37,6 +39,11 @@ namespace big
 		std::mutex m_to_do_file_callback_lock;
 		std::queue<std::tuple<lua_module*, std::string, std::string, std::time_t>> m_to_do_file_callback_queue;
 
+		std::atomic<uint64_t> m_async_scan_request_id{};
+		std::mutex m_to_do_async_scan_callback_lock;
+		// Module, request id, found address (0 if not found). Filled from the thread pool, consumed on the main thread.
+		std::queue<std::tuple<lua_module*, uint64_t, uintptr_t>> m_to_do_async_scan_callback_queue;
+
 	public:
 
 		std::recursive_mutex m_module_lock;
@@ -56,9 +63,28 @@ namespace big
 		using on_lua_state_init_t  = std::function<void(sol::state_view&, sol::table&)>;
 		using get_env_for_module_t = std::function<sol::environment(sol::state_view&)>;
 
+		// Lua callbacks of every module for one dynamic hook target, in module load order.
+		using dynamic_hook_callbacks_t = std::shared_ptr<const std::vector<sol::protected_function>>;
+
+		struct dynamic_hook_dispatch_t
+		{
+			ankerl::unordered_dense::map<uintptr_t, dynamic_hook_callbacks_t> m_pre;
+			ankerl::unordered_dense::map<uintptr_t, dynamic_hook_callbacks_t> m_post;
+			ankerl::unordered_dense::map<uintptr_t, dynamic_hook_callbacks_t> m_mid;
+		};
+
 	private:
 		on_lua_state_init_t m_on_lua_state_init;
 
+		// Checked without locking by the hooked functions, which load it again under m_module_lock before calling anything.
+		// Replaced as a whole under m_module_lock (copy on write) whenever a module registers a dynamic hook callback or is cleaned up.
+		std::atomic<std::shared_ptr<const dynamic_hook_dispatch_t>> m_dynamic_hook_dispatch{std::make_shared<const dynamic_hook_dispatch_t>()};
+		// Replaced tables stay here until no hooked function uses them anymore,
+		// that way the Lua references they hold are only ever released under m_module_lock.
+		std::vector<std::shared_ptr<const dynamic_hook_dispatch_t>> m_retired_dynamic_hook_dispatch;
+
+		void publish_dynamic_hook_dispatch(std::shared_ptr<const dynamic_hook_dispatch_t> dispatch);
+
 		bool m_is_all_mods_loaded{};
 
 		get_env_for_module_t m_get_env_for_module;
@@ -319,6 +345,9 @@ namespace big
 			}
 
 			m_is_all_mods_loaded = true;
+
+			// Persists the scan_pattern results of every mod at once.
+			::memory::g_pattern_cache.flush();
 		}
 
 		void unload_all_modules();
@@ -338,6 +367,10 @@ namespace big
 		bool dynamic_hook_pre_callbacks(const uintptr_t target_func_ptr, lua::memory::type_info_t return_type, lua::memory::runtime_func_t::return_value_t* return_value, std::vector<lua::memory::type_info_t> param_types, const lua::memory::runtime_func_t::parameters_t* params, const uint8_t param_count);
 		void dynamic_hook_post_callbacks(const uintptr_t target_func_ptr, lua::memory::type_info_t return_type, lua::memory::runtime_func_t::return_value_t* return_value, std::vector<lua::memory::type_info_t> param_types, const lua::memory::runtime_func_t::parameters_t* params, const uint8_t param_count);
 		uintptr_t dynamic_hook_mid_callbacks(const uintptr_t target_func_ptr, sol::table& args);
+		// Must be called after changing the dynamic hook callbacks of a module for target_func_ptr.
+		void update_dynamic_hook_dispatch(const uintptr_t target_func_ptr);
+		// Must be called after a module is cleaned up or unloaded.
+		void rebuild_dynamic_hook_dispatch();
 		sol::object to_lua(const lua::memory::runtime_func_t::parameters_t* params, const uint8_t i, const std::vector<lua::memory::type_info_t>& param_types);
 		sol::object to_lua(lua::memory::runtime_func_t::return_value_t* return_value, const lua::memory::type_info_t return_value_type);
 
@@ -50,6 +50,9 @@ namespace big
 
 			ankerl::unordered_dense::map<std::string, std::vector<sol::protected_function>> m_file_watchers;
 
+			// Keyed by async scan request id, dropped on reload so results of a previous load are never delivered.
+			ankerl::unordered_dense::map<uint64_t, sol::protected_function> m_async_scan_callbacks;
+
 			std::vector<std::unique_ptr<toml_v2::config_file>> m_config_files;
 		};
 
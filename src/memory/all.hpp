@@ -3,8 +3,26 @@
 #include "batch.hpp"
 #include "byte_patch.hpp"
 #include "handle.hpp"
+#include "import_index.hpp"
+#include "length_decoder.hpp"
 #include "module.hpp"
+#include "module_registry.hpp"
+#include "multi_pattern.hpp"
 #include "pattern.hpp"
+#include "pattern_cache.hpp"
+#include "pe.hpp"
+#include "pe_image.hpp"
 #include "range.hpp"
+#include "region.hpp"
+#include "rtti_index.hpp"
+#include "rtti_index_cache.hpp"
 #include "rw.hpp"
+#include "scanner.hpp"
 #include "signature.hpp"
+#include "signature_cache.hpp"
+#include "signature_generator.hpp"
+#include "static_pattern.hpp"
+#include "string_index.hpp"
+#include "value_scanner.hpp"
+#include "xref_index.hpp"
+#include "xref_index_cache.hpp"
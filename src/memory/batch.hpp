@@ -1,9 +1,18 @@
 #pragma once
+#include "module.hpp"
+#include "module_registry.hpp"
+#include "multi_pattern.hpp"
 #include "pattern.hpp"
 #include "range.hpp"
 #include "signature.hpp"
-
-#include <future>
+#include "signature_cache.hpp"
+#include "signature_hasher.hpp"
+#include "static_pattern.hpp"
+
+#include <algorithm>
+#include <file_manager/file_manager.hpp>
+#include <format>
+#include <thread>
 #include <rom/rom.hpp>
 
 // clang-format off
@@ -32,96 +41,184 @@ namespace memory
 		uint32_t m_hash;
 	};
 
-	struct signature_hasher
+	template<signature... args>
+	static inline constexpr auto make_batch(uint32_t hash = signature_hasher::FNV_OFFSET_32)
 	{
-		static inline constexpr uint32_t FNV_PRIME_32  = 16'777'619u;
-		static inline constexpr uint32_t FNV_OFFSET_32 = 2'166'136'261u;
+		constexpr std::array<signature, sizeof...(args)> a1 = {args...};
+
+		constexpr memory::batch<a1.size()> h(a1);
+
+		return batch_and_hash<a1.size()>{h, signature_hasher::add<args...>()};
+	}
 
-		static inline constexpr uint32_t fnv1a_32(const char* str, uint32_t hash = FNV_OFFSET_32) noexcept
+	struct batch_runner
+	{
+		inline static std::mutex s_entry_mutex;
+
+		template<size_t N>
+		inline static bool run(const memory::batch<N> batch, range region)
 		{
-			return (str[0] == '\0') ? hash : fnv1a_32(&str[1], (hash ^ static_cast<uint32_t>(str[0])) * FNV_PRIME_32);
+			return run_entries(batch.m_entries.data(), N, region, std::max(1u, std::thread::hardware_concurrency()));
 		}
 
-		template<signature sig>
-		static inline constexpr uint32_t compute_hash(uint32_t hash)
+		template<size_t N>
+		inline static bool run_sync(const memory::batch<N> batch, range region)
 		{
-			hash = fnv1a_32(sig.m_ida, hash);
+			return run_entries(batch.m_entries.data(), N, region, 1);
+		}
 
-			return hash;
+		inline static bool scan_pattern_and_execute_callback(range region, signature entry)
+		{
+			std::vector<pattern> parsed;
+			return execute_callback(region, entry, region.scan(view_of(entry, parsed)));
 		}
 
-		template<signature sig, signature... rest_sigs>
-		static inline constexpr uint32_t add(uint32_t hash = FNV_OFFSET_32)
+		/**
+		 * @brief Same as run but the resolved addresses are persisted to disk for this exact module build (PE timestamp + image size).
+		 * On the next launch the cached addresses are only validated with a byte compare, and only the missing ones are scanned for.
+		 */
+		template<size_t N>
+		inline static bool run(const memory::batch_and_hash<N>& batch, const module& mod)
 		{
-			hash = compute_hash<sig>(hash);
+			return run_entries_cached(batch.m_batch.m_entries.data(), N, batch.m_hash, mod, std::max(1u, std::thread::hardware_concurrency()));
+		}
 
-			if constexpr (sizeof...(rest_sigs) > 0)
+		// Same as above, the module is taken from the shared module registry.
+		template<size_t N>
+		inline static bool run(const memory::batch_and_hash<N>& batch, std::string_view module_name)
+		{
+			const auto mod = g_module_registry.get(module_name);
+			if (!mod)
 			{
-				hash = add<rest_sigs...>(hash);
+				LOG(WARNING) << "Module " << module_name << " is not loaded.";
+				return false;
 			}
 
-			return hash;
+			return run(batch, *mod);
 		}
-	};
 
-	template<signature... args>
-	static inline constexpr auto make_batch(uint32_t hash = signature_hasher::FNV_OFFSET_32)
-	{
-		constexpr std::array<signature, sizeof...(args)> a1 = {args...};
+	private:
+		// Bump when the layout of the cache data changes.
+		static constexpr uint64_t cache_format_version = 1;
 
-		constexpr memory::batch<a1.size()> h(a1);
-
-		return batch_and_hash<a1.size()>{h, signature_hasher::add<args...>()};
-	}
+		// Compiled pattern of a static_signature, the other signatures are parsed into parsed.
+		// Reserve parsed beforehand, the views of the patterns already in it must stay valid.
+		inline static scanner::pattern_view view_of(const signature& entry, std::vector<pattern>& parsed)
+		{
+			if (entry.m_pattern.m_size)
+			{
+				return entry.m_pattern;
+			}
 
-	struct batch_runner
-	{
-		inline static std::mutex s_entry_mutex;
-		inline static std::vector<std::future<bool>> g_futures;
+			return parsed.emplace_back(entry.m_ida).view();
+		}
 
-		template<size_t N>
-		inline static bool run(const memory::batch<N> batch, range region)
+		inline static bool run_entries(const signature* entries, size_t entry_count, range region, size_t thread_count)
 		{
-			for (auto& entry : batch.m_entries)
+			std::vector<pattern> parsed;
+			std::vector<scanner::pattern_view> views;
+			parsed.reserve(entry_count);
+			views.reserve(entry_count);
+			for (size_t i = 0; i < entry_count; i++)
 			{
-				g_futures.emplace_back(std::async(&scan_pattern_and_execute_callback, region, entry));
+				views.push_back(view_of(entries[i], parsed));
 			}
 
+			// Every signature of the batch is found during a single pass over the region, split between the threads.
+			const scanner::multi_pattern matcher(std::move(views));
+			const auto offsets = region.scan_first(matcher, thread_count);
+
 			bool found_all_patterns = true;
-			for (auto& future : g_futures)
+			for (size_t i = 0; i < entry_count; i++)
 			{
-				future.wait();
+				std::optional<handle> result;
+				if (offsets[i] != scanner::npos)
+				{
+					result = region.begin().add(offsets[i]);
+				}
 
-				if (!future.get())
+				if (!execute_callback(region, entries[i], result))
 				{
 					found_all_patterns = false;
 				}
 			}
 
-			g_futures.clear();
-
 			return found_all_patterns;
 		}
 
-		template<size_t N>
-		inline static bool run_sync(const memory::batch<N> batch, range region)
+		inline static bool run_entries_cached(const signature* entries, size_t entry_count, uint32_t batch_hash, const module& mod, size_t thread_count)
 		{
-			bool found_all_patterns = true;
+			const auto cache_file_path = std::format("./cache/{}_{:08X}.bin", mod.name(), batch_hash);
+			signature_cache cache(big::g_file_manager.get_project_file(cache_file_path), (cache_format_version << 32) | batch_hash);
+			cache.load(mod.timestamp(), mod.size());
+
+			std::vector<pattern> parsed;
+			std::vector<scanner::pattern_view> patterns;
+			std::vector<uint32_t> keys;
+			std::vector<std::optional<handle>> results(entry_count);
+			std::vector<size_t> indices_to_scan;
+			parsed.reserve(entry_count);
+			patterns.reserve(entry_count);
+			keys.reserve(entry_count);
+			for (size_t i = 0; i < entry_count; i++)
+			{
+				const auto& sig = patterns.emplace_back(view_of(entries[i], parsed));
+				const auto key  = keys.emplace_back(signature_hasher::fnv1a_32(entries[i].m_ida));
 
-			for (auto& entry : batch.m_entries)
+				results[i] = cache.find(key, sig, mod);
+				if (!results[i].has_value())
+				{
+					indices_to_scan.push_back(i);
+				}
+			}
+
+			LOG(INFO) << entry_count - indices_to_scan.size() << "/" << entry_count << " signatures resolved from cache.";
+
+			if (indices_to_scan.size())
+			{
+				std::vector<scanner::pattern_view> views;
+				views.reserve(indices_to_scan.size());
+				for (const auto i : indices_to_scan)
+				{
+					views.push_back(patterns[i]);
+				}
+
+				// Signatures are code, only the executable sections are scanned. They are sorted by address so the first hit wins.
+				const scanner::multi_pattern matcher(std::move(views));
+				for (const auto& section_range : mod.section_ranges(section_type::executable))
+				{
+					const auto offsets = section_range.scan_first(matcher, thread_count);
+					for (size_t j = 0; j < indices_to_scan.size(); j++)
+					{
+						const auto i = indices_to_scan[j];
+						if (offsets[j] == scanner::npos || results[i].has_value())
+						{
+							continue;
+						}
+
+						results[i] = section_range.begin().add(offsets[j]);
+						cache.insert(keys[i], results[i].value(), mod);
+					}
+				}
+			}
+
+			bool found_all_patterns = true;
+			for (size_t i = 0; i < entry_count; i++)
 			{
-				if (!scan_pattern_and_execute_callback(region, entry))
+				if (!execute_callback(mod, entries[i], results[i]))
 				{
 					found_all_patterns = false;
 				}
 			}
 
+			cache.write();
+
 			return found_all_patterns;
 		}
 
-		inline static bool scan_pattern_and_execute_callback(range region, signature entry)
+		inline static bool execute_callback(range region, signature entry, std::optional<handle> result)
 		{
-			if (auto result = region.scan(entry.m_ida); result.has_value())
+			if (result.has_value())
 			{
 				if (entry.m_on_signature_found)
 				{
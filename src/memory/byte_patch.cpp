@@ -1,28 +1,43 @@
 #include "byte_patch.hpp"
 
+#include "hooks/hook_transaction.hpp"
+
 namespace memory
 {
 	byte_patch::~byte_patch()
 	{
 		restore();
+		big::hook_transaction::flush(this);
 	}
 
 	void byte_patch::apply() const
 	{
-		DWORD temp;
-
-		VirtualProtect(m_address, m_size, PAGE_EXECUTE_READWRITE, (PDWORD)&m_old_protect);
-		memcpy(m_address, m_value.get(), m_size);
-		VirtualProtect(m_address, m_size, m_old_protect, &temp);
+		big::hook_transaction::execute(
+		    this,
+		    [this]
+		    {
+			    DWORD temp;
+
+			    VirtualProtect(m_address, m_size, PAGE_EXECUTE_READWRITE, (PDWORD)&m_old_protect);
+			    memcpy(m_address, m_value.get(), m_size);
+			    VirtualProtect(m_address, m_size, m_old_protect, &temp);
+		    },
+		    false);
 	}
 
 	void byte_patch::restore() const
 	{
-		DWORD temp;
-
-		VirtualProtect(m_address, m_size, PAGE_EXECUTE_READWRITE, (PDWORD)&temp);
-		memcpy(m_address, m_original_bytes.get(), m_size);
-		VirtualProtect(m_address, m_size, m_old_protect, &temp);
+		big::hook_transaction::execute(
+		    this,
+		    [this]
+		    {
+			    DWORD temp;
+
+			    VirtualProtect(m_address, m_size, PAGE_EXECUTE_READWRITE, (PDWORD)&temp);
+			    memcpy(m_address, m_original_bytes.get(), m_size);
+			    VirtualProtect(m_address, m_size, m_old_protect, &temp);
+		    },
+		    false);
 	}
 
 	void byte_patch::remove() const
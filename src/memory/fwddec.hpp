@@ -9,3 +9,8 @@ namespace memory
 	class pattern_batch;
 	class byte_patch;
 } // namespace memory
+
+namespace memory::scanner
+{
+	class multi_pattern;
+} // namespace memory::scanner
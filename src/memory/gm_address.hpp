@@ -1,8 +1,9 @@
 #pragma once
+#include "module.hpp"
+#include "module_registry.hpp"
+#include "pattern_cache.hpp"
 
 #include <libloaderapi.h>
-#include <processthreadsapi.h>
-#include <Psapi.h>
 
 // clang-format off
 #include <AsyncLogger/Logger.hpp>
@@ -10,32 +11,6 @@ using namespace al;
 // clang-format on
 #undef ERROR
 
-struct module_info_helper
-{
-	static inline void get_module_base_and_size(uintptr_t* base, size_t* size, const char* module_name = nullptr)
-	{
-		*base = {};
-		*size = {};
-
-		MODULEINFO module_info = {};
-
-		HMODULE module = GetModuleHandleA(module_name);
-		if (module)
-		{
-			GetModuleInformation(GetCurrentProcess(), module, &module_info, sizeof MODULEINFO);
-		}
-
-		if (base)
-		{
-			*base = uintptr_t(module_info.lpBaseOfDll);
-		}
-		if (size)
-		{
-			*size = size_t(module_info.SizeOfImage);
-		}
-	}
-};
-
 /**
  * \brief Provides compact utility to scan patterns and manipulate addresses.
  */
@@ -54,95 +29,29 @@ struct gmAddress
 	}
 
 private:
-	static inline uintptr_t s_module_base_default_module;
-	static inline size_t s_module_size_default_module;
-
-	static inline void init_if_needed_default_module_info()
+	// Modules come from the shared registry, scans then go through the same engine as memory::range (SIMD prefilter) over the whole image.
+	// Results are memoized per module build by g_pattern_cache, like the Lua scan_pattern ones.
+	static inline std::shared_ptr<const memory::module> default_module()
 	{
-		static bool is_init = false;
-		if (!is_init)
-		{
-			module_info_helper::get_module_base_and_size(&s_module_base_default_module, &s_module_size_default_module);
-			is_init = true;
-		}
+		return memory::g_module_registry.get(HMODULE(nullptr));
 	}
 
-	static inline uintptr_t s_module_base_our_module;
-	static inline size_t s_module_size_our_module;
-
-	static inline void init_if_needed_our_module_info()
+	// The module this code is compiled into.
+	static inline std::shared_ptr<const memory::module> our_module()
 	{
-		static bool is_init = false;
-		if (!is_init)
-		{
-			module_info_helper::get_module_base_and_size(&s_module_base_our_module, &s_module_size_our_module, "d3d12.dll");
-			is_init = true;
-		}
+		HMODULE handle{};
+		GetModuleHandleExA(GET_MODULE_HANDLE_EX_FLAG_FROM_ADDRESS | GET_MODULE_HANDLE_EX_FLAG_UNCHANGED_REFCOUNT, reinterpret_cast<LPCSTR>(&our_module), &handle);
+		return handle ? memory::g_module_registry.get(handle) : nullptr;
 	}
 
-	static gmAddress scan_internal(const char* pattern_str, const char* debug_name, uintptr_t module_base, size_t module_size)
+	static gmAddress scan_internal(const char* pattern_str, const char* debug_name, const std::shared_ptr<const memory::module>& mod)
 	{
-		// Convert string pattern into byte array form
-		int16_t pattern[256];
-		uint8_t pattern_size = 0;
-		for (size_t i = 0; i < strlen(pattern_str); i += 3)
-		{
-			const char* cursor = pattern_str + i;
-
-			if (cursor[0] == '?')
-			{
-				pattern[pattern_size] = -1;
-			}
-			else
-			{
-				pattern[pattern_size] = static_cast<int16_t>(strtol(cursor, nullptr, 16));
-			}
-
-			// Support single '?' (we're incrementing by 3 expecting ?? and space, but with ? we must increment by 2)
-			if (cursor[1] == ' ')
-			{
-				i--;
-			}
-
-			pattern_size++;
-		}
-
-		// In two-end comparison we approach from both sides (left & right) so size is twice smaller
-		uint8_t scan_size = pattern_size;
-		if (scan_size % 2 == 0)
+		if (mod)
 		{
-			scan_size /= 2;
-		}
-		else
-		{
-			scan_size = pattern_size / 2 + 1;
-		}
-
-		// Search for string through whole module
-		// We use two-end comparison, nothing fancy but better than just brute force
-		for (size_t i = 0; i < module_size; i += 1)
-		{
-			const uint8_t* module_position = (uint8_t*)(module_base + i);
-			for (uint8_t j = 0; j < scan_size; j++)
+			if (const auto result = memory::g_pattern_cache.scan(*mod, pattern_str, memory::section_type::all))
 			{
-				int16_t left_expected = pattern[j];
-				int16_t left_actual   = module_position[j];
-
-				if (left_expected != -1 && left_actual != left_expected)
-				{
-					goto miss;
-				}
-
-				int16_t right_expected = pattern[pattern_size - j - 1];
-				int16_t right_actual   = module_position[pattern_size - j - 1];
-
-				if (right_expected != -1 && right_actual != right_expected)
-				{
-					goto miss;
-				}
+				return {result->as<uintptr_t>()};
 			}
-			return {module_base + i};
-		miss:;
 		}
 
 		if (debug_name)
@@ -155,16 +64,12 @@ private:
 public:
 	static inline gmAddress scan(const char* pattern_str, const char* debug_name = nullptr)
 	{
-		init_if_needed_default_module_info();
-
-		return scan_internal(pattern_str, debug_name, s_module_base_default_module, s_module_size_default_module);
+		return scan_internal(pattern_str, debug_name, default_module());
 	}
 
 	static inline gmAddress scan_me(const char* pattern_str, const char* debug_name = nullptr)
 	{
-		init_if_needed_our_module_info();
-
-		return scan_internal(pattern_str, debug_name, s_module_base_our_module, s_module_size_our_module);
+		return scan_internal(pattern_str, debug_name, our_module());
 	}
 
 	gmAddress offset(int32_t offset) const
@@ -0,0 +1,90 @@
+#include "import_index.hpp"
+
+#include <algorithm>
+#include <cctype>
+#include <string>
+#include <tuple>
+
+namespace memory
+{
+	static std::string to_lower(std::string_view str)
+	{
+		std::string result(str);
+		std::ranges::transform(result,
+		                       result.begin(),
+		                       [](unsigned char c)
+		                       {
+			                       return static_cast<char>(std::tolower(c));
+		                       });
+		return result;
+	}
+
+	static auto import_key(const pe::import_info& info)
+	{
+		return std::tie(info.m_dll, info.m_name, info.m_ordinal);
+	}
+
+	import_index::import_index(const uint8_t* image, std::size_t image_size) :
+	    m_imports(pe::read_imports(image, image_size))
+	{
+		for (auto& info : m_imports)
+		{
+			info.m_dll = to_lower(info.m_dll);
+		}
+
+		std::ranges::sort(m_imports,
+		                  [](const pe::import_info& a, const pe::import_info& b)
+		                  {
+			                  return import_key(a) < import_key(b);
+		                  });
+	}
+
+	std::optional<uint32_t> import_index::find(std::string_view dll, std::string_view symbol) const
+	{
+		if (symbol.empty())
+		{
+			return std::nullopt;
+		}
+
+		if (dll.empty())
+		{
+			const auto it = std::ranges::find(m_imports, symbol, &pe::import_info::m_name);
+			return it != m_imports.end() ? std::make_optional(it->m_slot_rva) : std::nullopt;
+		}
+
+		using name_key = std::tuple<std::string_view, std::string_view>;
+
+		const auto lower_dll  = to_lower(dll);
+		const auto projection = [](const pe::import_info& info)
+		{
+			return name_key(info.m_dll, info.m_name);
+		};
+
+		const auto it = std::ranges::lower_bound(m_imports, name_key(lower_dll, symbol), std::less{}, projection);
+		if (it == m_imports.end() || it->m_dll != lower_dll || it->m_name != symbol)
+		{
+			return std::nullopt;
+		}
+
+		return it->m_slot_rva;
+	}
+
+	std::optional<uint32_t> import_index::find(std::string_view dll, uint16_t ordinal) const
+	{
+		const auto lower_dll = to_lower(dll);
+		for (const auto& info : m_imports)
+		{
+			if (info.m_name.empty() && info.m_ordinal == ordinal && (dll.empty() || info.m_dll == lower_dll))
+			{
+				return info.m_slot_rva;
+			}
+		}
+
+		return std::nullopt;
+	}
+
+	const std::vector<pe::import_info>& import_index::imports() const
+	{
+		return m_imports;
+	}
+} // namespace memory
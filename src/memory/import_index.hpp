@@ -0,0 +1,37 @@
+#pragma once
+#include "pe.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <string_view>
+#include <vector>
+
+namespace memory
+{
+	/**
+	 * @brief Import address table slots of an image, looked up by DLL and symbol.
+	 * Built once from the import directory, lookups are a binary search.
+	 */
+	class import_index
+	{
+	public:
+		/**
+		 * @param image Start of the image laid out at its rvas, a loaded module or a pe_image.
+		 */
+		import_index(const uint8_t* image, std::size_t image_size);
+
+		/**
+		 * @param dll Case insensitive, "kernel32.dll". Empty to take the first DLL importing the symbol.
+		 * @return rva of the IAT slot of the import.
+		 */
+		std::optional<uint32_t> find(std::string_view dll, std::string_view symbol) const;
+		std::optional<uint32_t> find(std::string_view dll, uint16_t ordinal) const;
+
+		// Sorted by DLL (lower case) then symbol, imports by ordinal come first in their DLL.
+		const std::vector<pe::import_info>& imports() const;
+
+	private:
+		std::vector<pe::import_info> m_imports;
+	};
+} // namespace memory
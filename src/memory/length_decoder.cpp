@@ -0,0 +1,367 @@
+#include "length_decoder.hpp"
+
+#include <array>
+
+namespace memory::x64
+{
+	enum opcode_flags : uint16_t
+	{
+		modrm     = 1 << 0,
+		imm8      = 1 << 1,
+		imm16     = 1 << 2,
+		imm32     = 1 << 3, // imm16 with an operand size prefix
+		rel8      = 1 << 4,
+		rel32     = 1 << 5,
+		moffs     = 1 << 6, // 8 byte absolute address, 4 with an address size prefix
+		imm_v     = 1 << 7, // mov r, imm: 8 bytes with REX.W
+		group3    = 1 << 8, // test r/m, imm only for /0 and /1
+		invalid   = 1 << 9,
+		enter_imm = 1 << 10, // imm16 + imm8
+	};
+
+	using opcode_table = std::array<uint16_t, 256>;
+
+	static constexpr opcode_table make_one_byte_table()
+	{
+		opcode_table table{};
+
+		for (int alu = 0x00; alu <= 0x38; alu += 0x08)
+		{
+			table[alu + 0] = modrm;
+			table[alu + 1] = modrm;
+			table[alu + 2] = modrm;
+			table[alu + 3] = modrm;
+			table[alu + 4] = imm8;
+			table[alu + 5] = imm32;
+		}
+
+		for (const auto op : {0x06, 0x07, 0x0E, 0x16, 0x17, 0x1E, 0x1F, 0x27, 0x2F, 0x37, 0x3F, 0x60, 0x61, 0x82, 0x9A, 0xCE, 0xD4, 0xD5, 0xD6, 0xEA})
+		{
+			table[op] = invalid;
+		}
+
+		table[0x63] = modrm;
+		table[0x68] = imm32;
+		table[0x69] = modrm | imm32;
+		table[0x6A] = imm8;
+		table[0x6B] = modrm | imm8;
+		for (int op = 0x70; op <= 0x7F; op++)
+		{
+			table[op] = rel8;
+		}
+		table[0x80] = modrm | imm8;
+		table[0x81] = modrm | imm32;
+		table[0x83] = modrm | imm8;
+		for (int op = 0x84; op <= 0x8F; op++)
+		{
+			table[op] = modrm;
+		}
+		for (int op = 0xA0; op <= 0xA3; op++)
+		{
+			table[op] = moffs;
+		}
+		table[0xA8] = imm8;
+		table[0xA9] = imm32;
+		for (int op = 0xB0; op <= 0xB7; op++)
+		{
+			table[op] = imm8;
+		}
+		for (int op = 0xB8; op <= 0xBF; op++)
+		{
+			table[op] = imm32 | imm_v;
+		}
+		table[0xC0] = modrm | imm8;
+		table[0xC1] = modrm | imm8;
+		table[0xC2] = imm16;
+		table[0xC6] = modrm | imm8;
+		table[0xC7] = modrm | imm32;
+		table[0xC8] = enter_imm;
+		table[0xCA] = imm16;
+		table[0xCD] = imm8;
+		for (int op = 0xD0; op <= 0xD3; op++)
+		{
+			table[op] = modrm;
+		}
+		for (int op = 0xD8; op <= 0xDF; op++)
+		{
+			table[op] = modrm; // x87
+		}
+		for (int op = 0xE0; op <= 0xE3; op++)
+		{
+			table[op] = rel8; // loop, jrcxz
+		}
+		for (int op = 0xE4; op <= 0xE7; op++)
+		{
+			table[op] = imm8; // in / out
+		}
+		table[0xE8] = rel32;
+		table[0xE9] = rel32;
+		table[0xEB] = rel8;
+		table[0xF6] = modrm | imm8 | group3;
+		table[0xF7] = modrm | imm32 | group3;
+		table[0xFE] = modrm;
+		table[0xFF] = modrm;
+		return table;
+	}
+
+	static constexpr opcode_table make_0f_table()
+	{
+		opcode_table table{};
+		table.fill(modrm);
+
+		for (const auto op : {0x04, 0x0A, 0x0C, 0x0E, 0x0F, 0x24, 0x25, 0x26, 0x27, 0x36, 0x39, 0x3B, 0x3C, 0x3D, 0x3E, 0x3F, 0x7A, 0x7B, 0xA6, 0xA7, 0xFF})
+		{
+			table[op] = invalid;
+		}
+
+		// No ModRM: syscall, clts, sysret, invd, wbinvd, ud2, rdtsc..., emms, push / pop fs gs, cpuid, rsm, bswap.
+		for (const auto op : {0x05, 0x06, 0x07, 0x08, 0x09, 0x0B, 0x30, 0x31, 0x32, 0x33, 0x34, 0x35, 0x37, 0x77, 0xA0, 0xA1, 0xA2, 0xA8, 0xA9, 0xAA})
+		{
+			table[op] = 0;
+		}
+		for (int op = 0xC8; op <= 0xCF; op++)
+		{
+			table[op] = 0;
+		}
+		for (int op = 0x80; op <= 0x8F; op++)
+		{
+			table[op] = rel32; // jcc rel32
+		}
+
+		for (const auto op : {0x70, 0x71, 0x72, 0x73, 0xA4, 0xAC, 0xBA, 0xC2, 0xC4, 0xC5, 0xC6})
+		{
+			table[op] |= imm8;
+		}
+		return table;
+	}
+
+	static constexpr auto one_byte_table = make_one_byte_table();
+	static constexpr auto table_0f       = make_0f_table();
+
+	enum class opcode_map : uint8_t
+	{
+		one_byte,
+		map_0f,
+		map_0f38,
+		map_0f3a,
+	};
+
+	std::optional<instruction> decode_length(const uint8_t* code, std::size_t available)
+	{
+		constexpr std::size_t max_length = 15;
+		if (available > max_length)
+		{
+			available = max_length;
+		}
+
+		std::size_t i            = 0;
+		bool operand_size_prefix = false;
+		bool address_size_prefix = false;
+		bool rex_w               = false;
+		const auto can_read      = [&](std::size_t count)
+		{
+			return i + count <= available;
+		};
+
+		// Legacy prefixes.
+		for (; can_read(1); i++)
+		{
+			const auto prefix = code[i];
+			if (prefix == 0x66)
+			{
+				operand_size_prefix = true;
+			}
+			else if (prefix == 0x67)
+			{
+				address_size_prefix = true;
+			}
+			else if (prefix != 0xF0 && prefix != 0xF2 && prefix != 0xF3 && prefix != 0x2E && prefix != 0x36 && prefix != 0x3E && prefix != 0x26 && prefix != 0x64 && prefix != 0x65)
+			{
+				break;
+			}
+		}
+
+		if (can_read(1) && (code[i] & 0xF0) == 0x40)
+		{
+			rex_w = code[i] & 0x08;
+			i++;
+		}
+
+		if (!can_read(1))
+		{
+			return std::nullopt;
+		}
+
+		uint16_t flags;
+		auto map = opcode_map::one_byte;
+
+		const auto opcode = code[i];
+		if (opcode == 0xC4 || opcode == 0xC5 || opcode == 0x62)
+		{
+			// VEX / EVEX: the payload holds the opcode map, then always opcode + ModRM, plus an imm8 in the 0F 3A map.
+			const std::size_t payload_size = opcode == 0xC5 ? 1 : opcode == 0xC4 ? 2 : 3;
+			if (!can_read(1 + payload_size + 1))
+			{
+				return std::nullopt;
+			}
+
+			const auto map_select = opcode == 0xC5 ? 1 : code[i + 1] & (opcode == 0xC4 ? 0x1F : 0x07);
+			map                   = map_select == 2 ? opcode_map::map_0f38 : map_select == 3 ? opcode_map::map_0f3a : opcode_map::map_0f;
+
+			i    += 1 + payload_size;
+			flags = map == opcode_map::map_0f ? table_0f[code[i]] : static_cast<uint16_t>(modrm);
+			i++;
+		}
+		else if (opcode == 0x0F)
+		{
+			if (!can_read(2))
+			{
+				return std::nullopt;
+			}
+
+			const auto second = code[i + 1];
+			if (second == 0x38 || second == 0x3A)
+			{
+				if (!can_read(3))
+				{
+					return std::nullopt;
+				}
+
+				map   = second == 0x38 ? opcode_map::map_0f38 : opcode_map::map_0f3a;
+				flags = modrm;
+				i    += 3;
+			}
+			else
+			{
+				map   = opcode_map::map_0f;
+				flags = table_0f[second];
+				i    += 2;
+			}
+		}
+		else
+		{
+			flags = one_byte_table[opcode];
+			i++;
+		}
+
+		if (map == opcode_map::map_0f3a)
+		{
+			flags |= imm8;
+		}
+
+		if (flags & invalid)
+		{
+			return std::nullopt;
+		}
+
+		instruction result{};
+
+		if (flags & modrm)
+		{
+			if (!can_read(1))
+			{
+				return std::nullopt;
+			}
+
+			const auto modrm_byte = code[i++];
+			const auto mod        = modrm_byte >> 6;
+			const auto rm         = modrm_byte & 0x07;
+
+			// test r/m, imm is the only group 3 instruction with an immediate.
+			if ((flags & group3) && ((modrm_byte >> 3) & 0x07) > 1)
+			{
+				flags &= ~(imm8 | imm32);
+			}
+
+			uint8_t displacement_size = 0;
+			if (mod != 3)
+			{
+				if (rm == 4)
+				{
+					if (!can_read(1))
+					{
+						return std::nullopt;
+					}
+
+					const auto sib = code[i++];
+					if (mod == 0 && (sib & 0x07) == 5)
+					{
+						displacement_size = 4;
+					}
+				}
+				else if (mod == 0 && rm == 5)
+				{
+					displacement_size     = 4;
+					result.m_rip_relative = true;
+				}
+
+				if (mod == 1)
+				{
+					displacement_size = 1;
+				}
+				else if (mod == 2)
+				{
+					displacement_size = 4;
+				}
+			}
+
+			if (displacement_size)
+			{
+				result.m_displacement_offset = static_cast<uint8_t>(i);
+				result.m_displacement_size   = displacement_size;
+				i += displacement_size;
+			}
+		}
+
+		uint8_t immediate_size = 0;
+		if (flags & imm8)
+		{
+			immediate_size = 1;
+		}
+		else if (flags & imm16)
+		{
+			immediate_size = 2;
+		}
+		else if (flags & enter_imm)
+		{
+			immediate_size = 3;
+		}
+		else if (flags & imm_v)
+		{
+			immediate_size = rex_w ? 8 : operand_size_prefix ? 2 : 4;
+		}
+		else if (flags & imm32)
+		{
+			immediate_size = operand_size_prefix ? 2 : 4;
+		}
+		else if (flags & moffs)
+		{
+			immediate_size = address_size_prefix ? 4 : 8;
+		}
+		else if (flags & rel8)
+		{
+			immediate_size              = 1;
+			result.m_relative_immediate = true;
+		}
+		else if (flags & rel32)
+		{
+			immediate_size              = 4;
+			result.m_relative_immediate = true;
+		}
+
+		if (immediate_size)
+		{
+			result.m_immediate_offset = static_cast<uint8_t>(i);
+			result.m_immediate_size   = immediate_size;
+			i += immediate_size;
+		}
+
+		if (i > available)
+		{
+			return std::nullopt;
+		}
+
+		result.m_length = static_cast<uint8_t>(i);
+		return result;
+	}
+} // namespace memory::x64
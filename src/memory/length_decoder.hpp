@@ -0,0 +1,30 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+
+namespace memory::x64
+{
+	struct instruction
+	{
+		uint8_t m_length;
+		// Offset from the start of the instruction, 0 sized when absent.
+		uint8_t m_displacement_offset;
+		uint8_t m_displacement_size;
+		uint8_t m_immediate_offset;
+		uint8_t m_immediate_size;
+		// [rip + disp32] operand, the displacement changes whenever code or data moves.
+		bool m_rip_relative;
+		// The immediate is a rel8 / rel32 branch target (jcc, jmp, call, loop).
+		bool m_relative_immediate;
+	};
+
+	/**
+	 * @brief Length decoder for 64-bit code: finds the size of an instruction and where its displacement and immediate are, without disassembling it.
+	 * Covers the legacy, VEX and EVEX encodings.
+	 *
+	 * @param available Readable bytes at code, the decoder never reads past them.
+	 * @return nullopt for invalid or truncated instructions.
+	 */
+	std::optional<instruction> decode_length(const uint8_t* code, std::size_t available);
+} // namespace memory::x64
@@ -1,6 +1,12 @@
 #include "module.hpp"
 
 #include "logger/logger.hpp"
+#include "module_registry.hpp"
+
+#include <ankerl/unordered_dense.h>
+#include <cstdlib>
+#include <filesystem>
+#include <mutex>
 
 namespace memory
 {
@@ -9,33 +15,319 @@ namespace memory
 		try_get_module();
 	}
 
-	handle module::get_export(std::string_view symbol_name)
+	module::module(HMODULE handle) :range(nullptr, 0), m_loaded(false)
+	{
+		if (!handle)
+		{
+			handle = GetModuleHandleA(nullptr);
+		}
+
+		char path[MAX_PATH]{};
+		if (GetModuleFileNameA(handle, path, MAX_PATH))
+		{
+			m_name = std::filesystem::path(path).filename().string();
+		}
+
+		try_get_module();
+	}
+
+	struct module::export_index
+	{
+		// Name -> index into the function rva array. The names point into the module export table.
+		ankerl::unordered_dense::map<std::string_view, uint32_t> m_name_to_function;
+		const uint32_t* m_functions{};
+		uint32_t m_function_count{};
+		uint32_t m_ordinal_base{};
+
+		// Function rvas inside the export directory are forwarder strings ("NTDLL.RtlAllocateHeap" or "NTDLL.#12").
+		uint32_t m_directory_begin{};
+		uint32_t m_directory_end{};
+	};
+
+	const module::export_index* module::exports() const
+	{
+		static std::mutex s_export_index_lock;
+		std::scoped_lock lock(s_export_index_lock);
+
+		if (m_export_index || !m_loaded)
+		{
+			return m_export_index.get();
+		}
+
+		auto index = std::make_shared<export_index>();
+
+		const auto nt = pe::read_nt_headers(m_base.as<const uint8_t*>(), m_size);
+		if (nt && pe::directory_export < nt->m_optional_header.m_number_of_rva_and_sizes)
+		{
+			const auto& directory = nt->m_optional_header.m_data_directory[pe::directory_export];
+			if (directory.m_virtual_address && directory.m_size)
+			{
+				const auto export_directory = m_base.add(directory.m_virtual_address).as<const pe::export_directory*>();
+				const auto names            = m_base.add(export_directory->m_address_of_names).as<const uint32_t*>();
+				const auto name_ordinals    = m_base.add(export_directory->m_address_of_name_ordinals).as<const uint16_t*>();
+
+				index->m_functions       = m_base.add(export_directory->m_address_of_functions).as<const uint32_t*>();
+				index->m_function_count  = export_directory->m_number_of_functions;
+				index->m_ordinal_base    = export_directory->m_base;
+				index->m_directory_begin = directory.m_virtual_address;
+				index->m_directory_end   = directory.m_virtual_address + directory.m_size;
+
+				index->m_name_to_function.reserve(export_directory->m_number_of_names);
+				for (uint32_t i = 0; i < export_directory->m_number_of_names; i++)
+				{
+					index->m_name_to_function.emplace(m_base.add(names[i]).as<const char*>(), name_ordinals[i]);
+				}
+			}
+		}
+
+		m_export_index = std::move(index);
+		return m_export_index.get();
+	}
+
+	const import_index* module::imports() const
+	{
+		static std::mutex s_import_index_lock;
+		std::scoped_lock lock(s_import_index_lock);
+
+		if (m_import_index || !m_loaded)
+		{
+			return m_import_index.get();
+		}
+
+		m_import_index = std::make_shared<const import_index>(m_base.as<const uint8_t*>(), m_size);
+		return m_import_index.get();
+	}
+
+	handle module::get_import_slot(std::string_view dll_name, std::string_view symbol_name) const
+	{
+		const auto index = imports();
+		if (!index)
+		{
+			return nullptr;
+		}
+
+		const auto slot_rva = index->find(dll_name, symbol_name);
+		if (!slot_rva)
+		{
+			return nullptr;
+		}
+
+		return m_base.add(*slot_rva);
+	}
+
+	handle module::resolve_export(uint32_t function_index, int forward_depth) const
+	{
+		const auto index = exports();
+		if (!index || function_index >= index->m_function_count)
+		{
+			return nullptr;
+		}
+
+		const auto rva = index->m_functions[function_index];
+		if (!rva)
+		{
+			return nullptr;
+		}
+
+		if (rva < index->m_directory_begin || rva >= index->m_directory_end)
+		{
+			return m_base.add(rva);
+		}
+
+		// Forwarder chains are short, the limit only guards against broken tables.
+		constexpr int max_forward_depth = 8;
+
+		const std::string_view forwarder = m_base.add(rva).as<const char*>();
+		const auto separator             = forwarder.rfind('.');
+		if (forward_depth >= max_forward_depth || separator == std::string_view::npos)
+		{
+			return nullptr;
+		}
+
+		const auto target_module = g_module_registry.get(std::string(forwarder.substr(0, separator)) + ".dll");
+		if (!target_module)
+		{
+			return nullptr;
+		}
+
+		const auto& target = *target_module;
+
+		const auto target_symbol = forwarder.substr(separator + 1);
+		if (target_symbol.starts_with('#'))
+		{
+			const auto ordinal      = static_cast<uint32_t>(std::strtoul(std::string(target_symbol.substr(1)).c_str(), nullptr, 10));
+			const auto target_index = target.exports();
+			if (!target_index || ordinal < target_index->m_ordinal_base)
+			{
+				return nullptr;
+			}
+
+			return target.resolve_export(ordinal - target_index->m_ordinal_base, forward_depth + 1);
+		}
+
+		const auto target_index = target.exports();
+		if (!target_index)
+		{
+			return nullptr;
+		}
+
+		const auto it = target_index->m_name_to_function.find(target_symbol);
+		if (it == target_index->m_name_to_function.end())
+		{
+			return nullptr;
+		}
+
+		return target.resolve_export(it->second, forward_depth + 1);
+	}
+
+	handle module::get_export(std::string_view symbol_name) const
 	{
-		if (!m_loaded)
+		const auto index = exports();
+		if (!index)
 		{
 			return nullptr;
 		}
 
-		const auto dosHeader          = m_base.as<IMAGE_DOS_HEADER*>();
-		const auto ntHeader           = m_base.add(dosHeader->e_lfanew).as<IMAGE_NT_HEADERS*>();
-		const auto imageDataDirectory = ntHeader->OptionalHeader.DataDirectory[IMAGE_DIRECTORY_ENTRY_EXPORT];
-		const auto exportDirectory    = m_base.add(imageDataDirectory.VirtualAddress).as<IMAGE_EXPORT_DIRECTORY*>();
+		const auto it = index->m_name_to_function.find(symbol_name);
+		if (it == index->m_name_to_function.end())
+		{
+			return nullptr;
+		}
 
-		const auto nameOffsetArray     = m_base.add(exportDirectory->AddressOfNames).as<DWORD*>();
-		const auto ordinalArray        = m_base.add(exportDirectory->AddressOfNameOrdinals).as<DWORD*>();
-		const auto functionOffsetArray = m_base.add(exportDirectory->AddressOfFunctions).as<DWORD*>();
+		return resolve_export(it->second, 0);
+	}
+
+	handle module::get_export(uint16_t ordinal) const
+	{
+		const auto index = exports();
+		if (!index || ordinal < index->m_ordinal_base)
+		{
+			return nullptr;
+		}
+
+		return resolve_export(ordinal - index->m_ordinal_base, 0);
+	}
+
+	const std::vector<section>& module::sections() const
+	{
+		return m_sections;
+	}
+
+	std::vector<range> module::section_ranges(section_type types) const
+	{
+		if (m_sections.empty() || types == section_type::all)
+		{
+			return {*this};
+		}
 
-		for (std::size_t i = 0; i < exportDirectory->NumberOfFunctions; i++)
+		std::vector<range> ranges;
+		for (const auto& section : m_sections)
 		{
-			const auto functionName = m_base.add(nameOffsetArray[i]).as<const char*>();
-			if (strcmp(functionName, symbol_name.data()))
+			if (!has_section_type(types, section.m_type))
 			{
 				continue;
 			}
 
-			return functionOffsetArray + ordinalArray[i];
+			if (ranges.size() && ranges.back().end() == section.m_range.begin())
+			{
+				ranges.back() = range(ranges.back().begin(), ranges.back().size() + section.m_range.size());
+				continue;
+			}
+
+			ranges.push_back(section.m_range);
+		}
+
+		return ranges;
+	}
+
+	std::optional<handle> module::scan(const pattern& sig, section_type types) const
+	{
+		return scan(sig.view(), types);
+	}
+
+	std::optional<handle> module::scan(const scanner::pattern_view& sig, section_type types) const
+	{
+		for (const auto& section_range : section_ranges(types))
+		{
+			if (const auto result = section_range.scan(sig))
+			{
+				return result;
+			}
+		}
+
+		return std::nullopt;
+	}
+
+	std::optional<handle> module::scan_parallel(const pattern& sig, section_type types) const
+	{
+		return scan_parallel(sig.view(), types);
+	}
+
+	std::optional<handle> module::scan_parallel(const scanner::pattern_view& sig, section_type types) const
+	{
+		for (const auto& section_range : section_ranges(types))
+		{
+			if (const auto result = section_range.scan_parallel(sig))
+			{
+				return result;
+			}
+		}
+
+		return std::nullopt;
+	}
+
+	std::vector<handle> module::scan_all(const pattern& sig, section_type types) const
+	{
+		std::vector<handle> result{};
+		scan_all(sig, result, types);
+		return result;
+	}
+
+	void module::scan_all(const pattern& sig, std::vector<handle>& out, section_type types) const
+	{
+		scan_all(sig.view(), out, types);
+	}
+
+	void module::scan_all(const scanner::pattern_view& sig, std::vector<handle>& out, section_type types) const
+	{
+		const auto ranges = section_ranges(types);
+		if (ranges.size() == 1)
+		{
+			return ranges.front().scan_all(sig, out);
 		}
-		return nullptr;
+
+		out.clear();
+
+		std::vector<handle> section_results;
+		for (const auto& section_range : ranges)
+		{
+			section_range.scan_all(sig, section_results);
+			out.insert(out.end(), section_results.begin(), section_results.end());
+		}
+	}
+
+	std::optional<function_bounds> module::function_containing(handle address) const
+	{
+		const auto image = m_base.as<const uint8_t*>();
+		const auto rva   = address.as<uintptr_t>() - m_base.as<uintptr_t>();
+		if (!m_loaded || address.as<uintptr_t>() < m_base.as<uintptr_t>() || rva >= m_size)
+		{
+			return std::nullopt;
+		}
+
+		const auto fragment = pe::find_runtime_function(m_runtime_functions, static_cast<uint32_t>(rva));
+		const auto primary  = pe::primary_runtime_function(image, m_size, m_runtime_functions, fragment);
+		if (!fragment || !primary)
+		{
+			return std::nullopt;
+		}
+
+		return function_bounds{m_base.add(primary->m_begin_address), range(m_base.add(fragment->m_begin_address), fragment->m_end_address - fragment->m_begin_address)};
+	}
+
+	std::string_view module::name() const
+	{
+		return m_name;
 	}
 
 	bool module::loaded() const
@@ -91,6 +383,19 @@ namespace memory
 		m_size      = ntHeader->OptionalHeader.SizeOfImage;
 		m_timestamp = ntHeader->FileHeader.TimeDateStamp;
 
+		parse_sections();
+
 		return m_loaded;
 	}
+
+	void module::parse_sections()
+	{
+		m_sections.clear();
+		for (auto& section : pe::read_sections(m_base.as<const uint8_t*>(), m_size))
+		{
+			m_sections.push_back({std::move(section.m_name), range(m_base.add(section.m_rva), section.m_size), section.m_type});
+		}
+
+		m_runtime_functions = pe::read_runtime_functions(m_base.as<const uint8_t*>(), m_size);
+	}
 } // namespace memory
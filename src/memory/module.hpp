@@ -1,25 +1,85 @@
 #pragma once
+#include "import_index.hpp"
+#include "pe.hpp"
 #include "range.hpp"
 
 #include <chrono>
+#include <memory>
+#include <span>
+#include <string>
 #include <string_view>
+#include <vector>
 #include <Windows.h>
 
 namespace memory
 {
+	struct section
+	{
+		std::string m_name;
+		range m_range;
+		section_type m_type;
+	};
+
+	struct function_bounds
+	{
+		// Entry point of the function.
+		handle m_entry;
+		// Exception directory entry holding the address. The whole function, unless the compiler split it in several fragments.
+		range m_fragment;
+	};
+
 	class module : public range
 	{
 	public:
 		explicit module(const std::string_view name);
+		// Module already loaded in the process, the name is taken from its file name. A null handle gives the process executable.
+		explicit module(HMODULE handle);
+
+		/**
+		 * @brief Sections of the module, sorted by address. Parsed once when the module is found.
+		 */
+		const std::vector<section>& sections() const;
+
+		/**
+		 * @brief Ranges covered by the sections of the given types, adjacent sections are merged into a single range.
+		 * section_type::all and a section table that could not be read give the whole image.
+		 */
+		std::vector<range> section_ranges(section_type types) const;
+
+		/**
+		 * @brief Function containing the address, from the exception directory (.pdata) entries. Leaf functions have no entry.
+		 * The fragment always contains the address, the entry point of a split function comes from its primary fragment.
+		 */
+		std::optional<function_bounds> function_containing(handle address) const;
+
+		// Module scans default to the executable sections, code signatures have nothing to find in headers, data or resources.
+		std::optional<handle> scan(const pattern& sig, section_type types = section_type::executable) const;
+		std::optional<handle> scan(const scanner::pattern_view& sig, section_type types = section_type::executable) const;
+		std::optional<handle> scan_parallel(const pattern& sig, section_type types = section_type::executable) const;
+		std::optional<handle> scan_parallel(const scanner::pattern_view& sig, section_type types = section_type::executable) const;
+		std::vector<handle> scan_all(const pattern& sig, section_type types = section_type::executable) const;
+		void scan_all(const pattern& sig, std::vector<handle>& out, section_type types = section_type::executable) const;
+		void scan_all(const scanner::pattern_view& sig, std::vector<handle>& out, section_type types = section_type::executable) const;
 
 		/**
 		 * @brief Get the export address of the current module given a symbol name
+		 * The export table is indexed on the first lookup, forwarded exports are resolved to their target module.
 		 * 
 		 * @param symbol_name 
 		 * @return memory::handle 
 		 */
-		memory::handle get_export(std::string_view symbol_name);
+		memory::handle get_export(std::string_view symbol_name) const;
+		memory::handle get_export(uint16_t ordinal) const;
 
+		/**
+		 * @brief Import address table slot of an import of the current module. The import directory is indexed on the first lookup.
+		 *
+		 * @param dll_name Case insensitive, empty to take the first DLL importing the symbol.
+		 * @return Address of the slot holding the imported function address, nullptr if the module does not import it.
+		 */
+		memory::handle get_import_slot(std::string_view dll_name, std::string_view symbol_name) const;
+
+		std::string_view name() const;
 		bool loaded() const;
 		size_t size() const;
 		DWORD timestamp() const;
@@ -37,8 +97,21 @@ namespace memory
 		bool try_get_module();
 
 	private:
-		const std::string_view m_name;
+		struct export_index;
+
+		void parse_sections();
+		const export_index* exports() const;
+		const import_index* imports() const;
+		memory::handle resolve_export(uint32_t function_index, int forward_depth) const;
+
+		std::string m_name;
 		bool m_loaded;
+		std::vector<section> m_sections;
+		// Points into the mapped image, already sorted by the linker.
+		std::span<const pe::runtime_function> m_runtime_functions;
+		// Built lazily, shared between copies of this module.
+		mutable std::shared_ptr<const export_index> m_export_index;
+		mutable std::shared_ptr<const import_index> m_import_index;
 
 	public:
 		template<class F>
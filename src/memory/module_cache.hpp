@@ -0,0 +1,92 @@
+#pragma once
+#include "module.hpp"
+#include "module_cache_file.hpp"
+
+#include <ankerl/unordered_dense.h>
+#include <string>
+#include <utility>
+
+namespace memory
+{
+	/**
+	 * @brief One load of one build of a module. In memory data computed from a module is only valid for the same key.
+	 */
+	struct module_cache_key
+	{
+		uintptr_t m_base;
+		size_t m_size;
+		uint32_t m_timestamp;
+
+		static module_cache_key of(const module& mod)
+		{
+			return {mod.begin().as<uintptr_t>(), mod.size(), mod.timestamp()};
+		}
+
+		// The base is left out, files stay valid across runs as long as the build is the same.
+		uint64_t file_version() const
+		{
+			return module_file_version(m_timestamp, m_size);
+		}
+
+		bool contains(uintptr_t address) const
+		{
+			return address >= m_base && address < m_base + m_size;
+		}
+
+		bool operator==(const module_cache_key&) const = default;
+	};
+
+	/**
+	 * @brief Per module data keyed by module name, reset to a default Entry when the module got reloaded or is another build.
+	 * Not thread safe, owners guard it with their own lock.
+	 */
+	template<typename Entry>
+	class module_entries
+	{
+	public:
+		Entry& get(const module& mod)
+		{
+			const auto key = module_cache_key::of(mod);
+
+			auto& [entry_key, entry] = m_entries[std::string(mod.name())];
+			if (!(entry_key == key))
+			{
+				entry_key = key;
+				entry     = {};
+			}
+
+			return entry;
+		}
+
+		// Entry of the module containing the address, nullptr if none.
+		Entry* find(uintptr_t address)
+		{
+			for (auto& [name, keyed_entry] : m_entries)
+			{
+				if (keyed_entry.first.contains(address))
+				{
+					return &keyed_entry.second;
+				}
+			}
+
+			return nullptr;
+		}
+
+		template<typename F>
+		void for_each(F&& func)
+		{
+			for (auto& [name, keyed_entry] : m_entries)
+			{
+				func(keyed_entry.second);
+			}
+		}
+
+		void clear()
+		{
+			m_entries.clear();
+		}
+
+	private:
+		ankerl::unordered_dense::map<std::string, std::pair<module_cache_key, Entry>> m_entries;
+	};
+} // namespace memory
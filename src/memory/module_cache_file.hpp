@@ -0,0 +1,90 @@
+#pragma once
+#include "file_manager/cache_file.hpp"
+#include "file_manager/file_manager.hpp"
+
+#include <cstdint>
+#include <cstring>
+#include <filesystem>
+#include <memory>
+#include <optional>
+#include <span>
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include <vector>
+
+namespace memory
+{
+	/**
+	 * @brief Version of the cache files of a module build: PE timestamp + image size.
+	 */
+	inline uint64_t module_file_version(uint32_t module_timestamp, size_t module_size)
+	{
+		return (static_cast<uint64_t>(module_timestamp) << 32) | static_cast<uint32_t>(module_size);
+	}
+
+	/**
+	 * @brief Cache file of an array of trivially copyable records computed from a module build, like the xref and RTTI indices.
+	 * Named <module>.<suffix>.bin inside the folder, nothing is read or written when the folder is empty.
+	 */
+	template<typename T>
+	class module_cache_file
+	{
+		static_assert(std::is_trivially_copyable_v<T>);
+
+	public:
+		/**
+		 * @param file_version Build of the module, see module_file_version.
+		 * @param cache_version Bump when the meaning or layout of the records changes.
+		 */
+		module_cache_file(const std::filesystem::path& folder, std::string_view module_name, uint64_t file_version, std::string_view suffix, uint64_t cache_version) :
+		    m_file_version(file_version)
+		{
+			if (!folder.empty())
+			{
+				m_file.emplace(big::file_manager::ensure_file_can_be_created(folder / (std::string(module_name) + "." + std::string(suffix) + ".bin")), cache_version);
+			}
+		}
+
+		/**
+		 * @return The records, only if the file was written for the same module build. They still come from disk: validate them before use.
+		 */
+		std::optional<std::vector<T>> load()
+		{
+			if (!m_file || !m_file->load() || !m_file->up_to_date(m_file_version) || m_file->data_size() % sizeof(T))
+			{
+				if (m_file)
+				{
+					m_file->free_data();
+				}
+				return std::nullopt;
+			}
+
+			std::vector<T> records(m_file->data_size() / sizeof(T));
+			std::memcpy(records.data(), m_file->data(), m_file->data_size());
+			m_file->free_data();
+			return records;
+		}
+
+		void write(std::span<const T> records)
+		{
+			if (!m_file)
+			{
+				return;
+			}
+
+			const auto data_size = records.size_bytes();
+			auto data            = std::make_unique<uint8_t[]>(data_size);
+			std::memcpy(data.get(), records.data(), data_size);
+
+			m_file->set_data(std::move(data), data_size);
+			m_file->set_header_version(m_file_version);
+			m_file->write();
+			m_file->free_data();
+		}
+
+	private:
+		uint64_t m_file_version;
+		std::optional<big::cache_file> m_file;
+	};
+} // namespace memory
@@ -0,0 +1,136 @@
+#include "module_registry.hpp"
+
+#include <algorithm>
+#include <cctype>
+#include <filesystem>
+#include <winternl.h>
+
+namespace memory
+{
+	// Not in the SDK headers, see LdrRegisterDllNotification on MSDN.
+	struct ldr_dll_notification_data
+	{
+		ULONG m_flags;
+		PCUNICODE_STRING m_full_dll_name;
+		PCUNICODE_STRING m_base_dll_name;
+		PVOID m_dll_base;
+		ULONG m_size_of_image;
+	};
+
+	constexpr ULONG ldr_dll_notification_reason_unloaded = 2;
+
+	using ldr_dll_notification_function_t   = VOID(CALLBACK*)(ULONG reason, const ldr_dll_notification_data* data, PVOID context);
+	using ldr_register_dll_notification_t   = NTSTATUS(NTAPI*)(ULONG flags, ldr_dll_notification_function_t callback, PVOID context, PVOID* cookie);
+	using ldr_unregister_dll_notification_t = NTSTATUS(NTAPI*)(PVOID cookie);
+
+	static std::string to_key(std::string_view name)
+	{
+		std::string key(name);
+		std::ranges::transform(key,
+		                       key.begin(),
+		                       [](unsigned char c)
+		                       {
+			                       return static_cast<char>(std::tolower(c));
+		                       });
+		return key;
+	}
+
+	static VOID CALLBACK on_dll_notification(ULONG reason, const ldr_dll_notification_data* data, PVOID context)
+	{
+		// Runs under the loader lock: only drop the cached entry, nothing here may load or query modules.
+		if (reason == ldr_dll_notification_reason_unloaded)
+		{
+			static_cast<module_registry*>(context)->invalidate(data->m_dll_base);
+		}
+	}
+
+	module_registry::~module_registry()
+	{
+		if (!m_notification_cookie)
+		{
+			return;
+		}
+
+		const auto unregister_notification = reinterpret_cast<ldr_unregister_dll_notification_t>(GetProcAddress(GetModuleHandleA("ntdll.dll"), "LdrUnregisterDllNotification"));
+		if (unregister_notification)
+		{
+			unregister_notification(m_notification_cookie);
+		}
+	}
+
+	void module_registry::register_load_notification()
+	{
+		const auto register_notification = reinterpret_cast<ldr_register_dll_notification_t>(GetProcAddress(GetModuleHandleA("ntdll.dll"), "LdrRegisterDllNotification"));
+		if (register_notification)
+		{
+			register_notification(0, &on_dll_notification, this, &m_notification_cookie);
+		}
+	}
+
+	std::shared_ptr<const module> module_registry::get(std::string_view name)
+	{
+		std::call_once(m_notification_once,
+		               [this]
+		               {
+			               register_load_notification();
+		               });
+
+		auto key = to_key(name);
+
+		{
+			std::scoped_lock lock(m_lock);
+			if (const auto it = m_modules.find(key); it != m_modules.end())
+			{
+				return it->second;
+			}
+		}
+
+		// Resolved outside of the lock, the loader lock must never be taken while holding ours.
+		auto mod = std::make_shared<const module>(name);
+		if (!mod->loaded())
+		{
+			return nullptr;
+		}
+
+		std::scoped_lock lock(m_lock);
+		return m_modules.try_emplace(std::move(key), std::move(mod)).first->second;
+	}
+
+	std::shared_ptr<const module> module_registry::get(HMODULE handle)
+	{
+		if (!handle)
+		{
+			handle = GetModuleHandleA(nullptr);
+		}
+
+		char path[MAX_PATH]{};
+		if (!GetModuleFileNameA(handle, path, MAX_PATH))
+		{
+			return nullptr;
+		}
+
+		return get(std::filesystem::path(path).filename().string());
+	}
+
+	void module_registry::invalidate(const void* module_base)
+	{
+		std::scoped_lock lock(m_lock);
+		for (auto it = m_modules.begin(); it != m_modules.end();)
+		{
+			if (it->second->begin().as<const void*>() == module_base)
+			{
+				it = m_modules.erase(it);
+			}
+			else
+			{
+				++it;
+			}
+		}
+	}
+
+	void module_registry::clear()
+	{
+		std::scoped_lock lock(m_lock);
+		m_modules.clear();
+	}
+} // namespace memory
@@ -0,0 +1,50 @@
+#pragma once
+#include "module.hpp"
+
+#include <ankerl/unordered_dense.h>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <Windows.h>
+
+namespace memory
+{
+	/**
+	 * @brief Process wide cache of loaded modules, so that the headers, section table and export index of a module are only parsed once per load.
+	 *
+	 * Entries are dropped when the loader reports the module as unloaded. Callers holding a module keep a valid descriptor,
+	 * but should not touch its memory after the module got unloaded, same as with a raw HMODULE.
+	 */
+	class module_registry
+	{
+	public:
+		~module_registry();
+
+		/**
+		 * @brief Case insensitive, same lookup rules as GetModuleHandleA.
+		 *
+		 * @return nullptr if the module is not loaded. Not found results are not cached, a later call will find the module once it loads.
+		 */
+		std::shared_ptr<const module> get(std::string_view name);
+
+		/**
+		 * @brief A null handle gives the process executable.
+		 */
+		std::shared_ptr<const module> get(HMODULE handle);
+
+		void invalidate(const void* module_base);
+		void clear();
+
+	private:
+		void register_load_notification();
+
+		std::mutex m_lock;
+		ankerl::unordered_dense::map<std::string, std::shared_ptr<const module>> m_modules;
+
+		std::once_flag m_notification_once;
+		void* m_notification_cookie{};
+	};
+
+	inline auto g_module_registry = module_registry();
+} // namespace memory
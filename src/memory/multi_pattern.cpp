@@ -0,0 +1,172 @@
+#include "multi_pattern.hpp"
+
+#include <algorithm>
+
+namespace memory::scanner
+{
+	static constexpr std::size_t pair_key_count = 0x1'00'00;
+
+	static inline uint32_t pair_key(const uint8_t* bytes)
+	{
+		return bytes[0] | (bytes[1] << 8);
+	}
+
+	multi_pattern::multi_pattern(std::vector<pattern_view> patterns) :
+	    m_patterns(std::move(patterns))
+	{
+		std::vector<std::pair<uint32_t, anchored_pattern>> pair_anchors;
+		std::vector<std::pair<uint32_t, anchored_pattern>> byte_anchors;
+
+		for (uint32_t index = 0; index < m_patterns.size(); ++index)
+		{
+			const auto& sig = m_patterns[index];
+
+			// Rarest pair of adjacent non-wildcard bytes.
+			std::size_t best_pair    = npos;
+			uint32_t best_pair_score = UINT32_MAX;
+			for (std::size_t i = 0; i + 1 < sig.m_size; ++i)
+			{
+				if (sig.m_masks[i] != 0xFF || sig.m_masks[i + 1] != 0xFF)
+				{
+					continue;
+				}
+
+				const uint32_t score = byte_commonness(sig.m_values[i]) + byte_commonness(sig.m_values[i + 1]);
+				if (score < best_pair_score)
+				{
+					best_pair       = i;
+					best_pair_score = score;
+				}
+			}
+
+			if (best_pair != npos)
+			{
+				pair_anchors.push_back({pair_key(sig.m_values + best_pair), {index, static_cast<uint32_t>(best_pair)}});
+			}
+			else if (sig.m_has_anchor)
+			{
+				byte_anchors.push_back({sig.m_values[sig.m_anchor], {index, static_cast<uint32_t>(sig.m_anchor)}});
+			}
+			else if (sig.m_size)
+			{
+				m_wildcard_only.push_back(index);
+			}
+		}
+
+		const auto build_table = [](std::vector<std::pair<uint32_t, anchored_pattern>>& anchors, std::size_t key_count, std::vector<uint32_t>& offsets, std::vector<anchored_pattern>& entries)
+		{
+			std::ranges::stable_sort(anchors,
+			                         [](const auto& a, const auto& b)
+			                         {
+				                         return a.first < b.first;
+			                         });
+
+			offsets.assign(key_count + 1, 0);
+			for (const auto& [key, entry] : anchors)
+			{
+				offsets[key + 1]++;
+			}
+			for (std::size_t key = 0; key < key_count; ++key)
+			{
+				offsets[key + 1] += offsets[key];
+			}
+
+			entries.reserve(anchors.size());
+			for (const auto& [key, entry] : anchors)
+			{
+				entries.push_back(entry);
+			}
+		};
+
+		build_table(pair_anchors, pair_key_count, m_pair_offsets, m_pair_entries);
+		build_table(byte_anchors, 0x1'00, m_byte_offsets, m_byte_entries);
+		m_has_byte_entries = !m_byte_entries.empty();
+
+		m_pair_filter.assign(pair_key_count / 64, 0);
+		for (const auto& [key, entry] : pair_anchors)
+		{
+			m_pair_filter[key / 64] |= 1ull << (key % 64);
+		}
+	}
+
+	std::size_t multi_pattern::size() const
+	{
+		return m_patterns.size();
+	}
+
+	std::vector<std::size_t> multi_pattern::find_first(const uint8_t* data, std::size_t size) const
+	{
+		return find_first(data, size, 0, size);
+	}
+
+	std::vector<std::size_t> multi_pattern::find_first(const uint8_t* data, std::size_t size, std::size_t anchor_begin, std::size_t anchor_end) const
+	{
+		std::vector<std::size_t> results(m_patterns.size(), npos);
+		if (!data || m_patterns.empty())
+		{
+			return results;
+		}
+
+		anchor_end = std::min(anchor_end, size);
+
+		std::size_t remaining = m_patterns.size();
+
+		for (const auto index : m_wildcard_only)
+		{
+			if (anchor_begin == 0 && m_patterns[index].m_size <= size)
+			{
+				results[index] = 0;
+			}
+			remaining--;
+		}
+
+		const auto try_entries = [&](const anchored_pattern* it, const anchored_pattern* end, std::size_t position)
+		{
+			for (; it != end; ++it)
+			{
+				auto& result = results[it->m_index];
+				if (result != npos || position < it->m_anchor_offset)
+				{
+					continue;
+				}
+
+				const auto& sig  = m_patterns[it->m_index];
+				const auto start = position - it->m_anchor_offset;
+				if (start + sig.m_size > size || !matches(data + start, sig))
+				{
+					continue;
+				}
+
+				result = start;
+				remaining--;
+			}
+		};
+
+		for (std::size_t position = anchor_begin; position < anchor_end && remaining; ++position)
+		{
+			if (m_has_byte_entries)
+			{
+				const auto byte = data[position];
+				if (m_byte_offsets[byte] != m_byte_offsets[byte + 1])
+				{
+					try_entries(m_byte_entries.data() + m_byte_offsets[byte], m_byte_entries.data() + m_byte_offsets[byte + 1], position);
+				}
+			}
+
+			if (position + 1 >= size)
+			{
+				continue;
+			}
+
+			const auto key = pair_key(data + position);
+			if (!(m_pair_filter[key / 64] & (1ull << (key % 64))))
+			{
+				continue;
+			}
+
+			try_entries(m_pair_entries.data() + m_pair_offsets[key], m_pair_entries.data() + m_pair_offsets[key + 1], position);
+		}
+
+		return results;
+	}
+} // namespace memory::scanner
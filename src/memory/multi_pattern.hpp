@@ -0,0 +1,61 @@
+#pragma once
+#include "scanner.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace memory::scanner
+{
+	/**
+	 * @brief Finds the first match of many patterns in a single pass over a buffer.
+	 *
+	 * Each pattern is indexed by its rarest pair of adjacent non-wildcard bytes (or its rarest byte when it has no such pair).
+	 * The pass then only does a bitset lookup per byte and verifies the few patterns sharing the anchor on a hit.
+	 */
+	class multi_pattern
+	{
+	public:
+		/**
+		 * @brief The views must stay valid for the lifetime of this object.
+		 */
+		explicit multi_pattern(std::vector<pattern_view> patterns);
+
+		std::size_t size() const;
+
+		/**
+		 * @brief Scans the whole buffer.
+		 *
+		 * @return Offset of the first match of each pattern from data, npos for the ones not found.
+		 */
+		std::vector<std::size_t> find_first(const uint8_t* data, std::size_t size) const;
+
+		/**
+		 * @brief Only considers anchors located inside [anchor_begin, anchor_end), matches themselves can still spill outside of it.
+		 * Used for splitting a buffer between threads, every match is owned by exactly one chunk.
+		 */
+		std::vector<std::size_t> find_first(const uint8_t* data, std::size_t size, std::size_t anchor_begin, std::size_t anchor_end) const;
+
+	private:
+		struct anchored_pattern
+		{
+			uint32_t m_index;
+			uint32_t m_anchor_offset;
+		};
+
+		std::vector<pattern_view> m_patterns;
+
+		// Patterns keyed by 2 adjacent bytes (little endian), stored as a compressed row table.
+		std::vector<uint64_t> m_pair_filter;
+		std::vector<uint32_t> m_pair_offsets;
+		std::vector<anchored_pattern> m_pair_entries;
+
+		// Patterns without 2 adjacent non-wildcard bytes, keyed by a single byte.
+		std::vector<uint32_t> m_byte_offsets;
+		std::vector<anchored_pattern> m_byte_entries;
+		bool m_has_byte_entries{};
+
+		// Patterns only made of wildcards always match at the first offset.
+		std::vector<uint32_t> m_wildcard_only;
+	};
+} // namespace memory::scanner
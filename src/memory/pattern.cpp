@@ -65,6 +65,8 @@ namespace memory
 				}
 			}
 		}
+
+		compile();
 	}
 
 	pattern::pattern(const void* bytes, std::string_view mask)
@@ -81,5 +83,33 @@ namespace memory
 				m_bytes.push_back(std::nullopt);
 			}
 		}
+
+		compile();
+	}
+
+	void pattern::compile()
+	{
+		m_values.resize(m_bytes.size());
+		m_masks.resize(m_bytes.size());
+
+		for (std::size_t i = 0; i < m_bytes.size(); ++i)
+		{
+			m_values[i] = m_bytes[i].value_or(0);
+			m_masks[i]  = m_bytes[i].has_value() ? 0xFF : 0x00;
+		}
+
+		m_has_anchor = scanner::pick_anchors(m_values.data(), m_masks.data(), m_values.size(), m_anchor, m_anchor2);
+	}
+
+	scanner::pattern_view pattern::view() const
+	{
+		return {
+		    .m_values     = m_values.data(),
+		    .m_masks      = m_masks.data(),
+		    .m_size       = m_values.size(),
+		    .m_anchor     = m_anchor,
+		    .m_anchor2    = m_anchor2,
+		    .m_has_anchor = m_has_anchor,
+		};
 	}
 } // namespace memory
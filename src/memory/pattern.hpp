@@ -1,6 +1,7 @@
 #pragma once
 #include "fwddec.hpp"
 #include "handle.hpp"
+#include "scanner.hpp"
 
 #include <cstdint>
 #include <optional>
@@ -23,6 +24,22 @@ namespace memory
 		{
 		}
 
+		/**
+		 * @brief Dense byte + mask view of the pattern, consumed by the scanning kernels.
+		 * Only valid as long as the pattern is alive and not modified.
+		 */
+		scanner::pattern_view view() const;
+
+	private:
+		void compile();
+
+		// Source of the compiled view, so private: changing it afterwards would leave the view stale.
 		std::vector<std::optional<uint8_t>> m_bytes;
+
+		std::vector<uint8_t> m_values;
+		std::vector<uint8_t> m_masks;
+		std::size_t m_anchor{};
+		std::size_t m_anchor2{};
+		bool m_has_anchor{};
 	};
 } // namespace memory
@@ -0,0 +1,167 @@
+#include "pattern_cache.hpp"
+
+#include "file_manager/file_manager.hpp"
+#include "multi_pattern.hpp"
+#include "pattern.hpp"
+#include "signature_hasher.hpp"
+
+#include <format>
+#include <thread>
+
+namespace memory
+{
+	// Bump when the meaning of the cached data changes.
+	static constexpr uint64_t pattern_cache_version = 1;
+
+	// Executable section keys are the plain hash of the pattern, shared with the batch scans.
+	static uint32_t cache_key(const std::string& ida, section_type types)
+	{
+		const auto hash = signature_hasher::fnv1a_32(ida.c_str());
+		return types == section_type::executable ? hash : signature_hasher::fnv1a_32(std::format(" {}", static_cast<int>(types)).c_str(), hash);
+	}
+
+	void pattern_cache::set_folder(const std::filesystem::path& folder)
+	{
+		std::scoped_lock lock(m_lock);
+		m_folder = folder;
+		m_modules.clear();
+	}
+
+	pattern_cache::module_entry& pattern_cache::get_entry(const module& mod)
+	{
+		auto& entry = m_modules[std::string(mod.name())];
+		if (entry.m_cache && entry.m_timestamp == mod.timestamp() && entry.m_size == mod.size())
+		{
+			return entry;
+		}
+
+		// First use, or the module got reloaded with another build.
+		big::file cache_file;
+		if (!m_folder.empty())
+		{
+			cache_file = big::file_manager::ensure_file_can_be_created(m_folder / std::format("{}.bin", mod.name()));
+		}
+
+		entry.m_timestamp = mod.timestamp();
+		entry.m_size      = mod.size();
+		entry.m_cache     = std::make_unique<signature_cache>(cache_file, pattern_cache_version);
+		if (!m_folder.empty())
+		{
+			entry.m_cache->load(entry.m_timestamp, entry.m_size);
+		}
+
+		return entry;
+	}
+
+	std::optional<handle> pattern_cache::scan(const module& mod, const std::string& ida, section_type types)
+	{
+		const auto key = cache_key(ida, types);
+		const pattern sig(ida);
+
+		{
+			std::scoped_lock lock(m_lock);
+			if (const auto result = get_entry(mod).m_cache->find(key, sig, mod))
+			{
+				return result;
+			}
+		}
+
+		// Scanned without the lock so that scans of different patterns run concurrently.
+		const auto result = mod.scan_parallel(sig, types);
+		if (!result)
+		{
+			return std::nullopt;
+		}
+
+		// Written by the next flush, a mod doing many scans at load must not rewrite the file for each of them.
+		std::scoped_lock lock(m_lock);
+		get_entry(mod).m_cache->insert(key, result.value(), mod);
+
+		return result;
+	}
+
+	std::vector<std::optional<handle>> pattern_cache::scan(const module& mod, const std::vector<std::string>& idas, section_type types)
+	{
+		std::vector<std::optional<handle>> results(idas.size());
+		std::vector<uint32_t> keys;
+		std::vector<pattern> patterns;
+		std::vector<size_t> indices_to_scan;
+		keys.reserve(idas.size());
+		patterns.reserve(idas.size());
+
+		{
+			std::scoped_lock lock(m_lock);
+			auto& entry = get_entry(mod);
+			for (size_t i = 0; i < idas.size(); i++)
+			{
+				const auto& sig = patterns.emplace_back(idas[i]);
+				const auto key  = keys.emplace_back(cache_key(idas[i], types));
+
+				results[i] = entry.m_cache->find(key, sig, mod);
+				if (!results[i].has_value())
+				{
+					indices_to_scan.push_back(i);
+				}
+			}
+		}
+
+		if (indices_to_scan.empty())
+		{
+			return results;
+		}
+
+		std::vector<scanner::pattern_view> views;
+		views.reserve(indices_to_scan.size());
+		for (const auto i : indices_to_scan)
+		{
+			views.push_back(patterns[i].view());
+		}
+
+		const scanner::multi_pattern matcher(std::move(views));
+		for (const auto& section_range : mod.section_ranges(types))
+		{
+			const auto offsets = section_range.scan_first(matcher, std::thread::hardware_concurrency());
+			for (size_t j = 0; j < indices_to_scan.size(); j++)
+			{
+				auto& result = results[indices_to_scan[j]];
+				if (!result.has_value() && offsets[j] != scanner::npos)
+				{
+					result = section_range.begin().add(offsets[j]);
+				}
+			}
+		}
+
+		std::scoped_lock lock(m_lock);
+		auto& entry = get_entry(mod);
+		for (const auto i : indices_to_scan)
+		{
+			if (results[i].has_value())
+			{
+				entry.m_cache->insert(keys[i], results[i].value(), mod);
+			}
+		}
+		if (!m_folder.empty())
+		{
+			entry.m_cache->write();
+		}
+
+		return results;
+	}
+
+	void pattern_cache::flush()
+	{
+		std::scoped_lock lock(m_lock);
+		if (m_folder.empty())
+		{
+			return;
+		}
+
+		for (auto& [name, entry] : m_modules)
+		{
+			if (entry.m_cache)
+			{
+				entry.m_cache->write();
+			}
+		}
+	}
+} // namespace memory
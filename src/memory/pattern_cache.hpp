@@ -0,0 +1,65 @@
+#pragma once
+#include "handle.hpp"
+#include "module.hpp"
+#include "signature_cache.hpp"
+
+#include <ankerl/unordered_dense.h>
+#include <filesystem>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace memory
+{
+	/**
+	 * @brief Memo of IDA pattern string -> first match, per module build.
+	 *
+	 * Lives in memory for the whole process and is persisted through a signature_cache file per module once a folder is set,
+	 * by the batch scans and by flush.
+	 * Every hit is validated with a byte compare against the pattern before being returned, so a stale entry only costs a rescan.
+	 */
+	class pattern_cache
+	{
+	public:
+		/**
+		 * @brief Folder holding the cache files. Results are only memoized in memory until this is set.
+		 */
+		void set_folder(const std::filesystem::path& folder);
+
+		/**
+		 * @brief Cached version of mod.scan_parallel(pattern(ida), types). Each section filter has its own results.
+		 */
+		std::optional<handle> scan(const module& mod, const std::string& ida, section_type types = section_type::executable);
+
+		/**
+		 * @brief Same as above for many patterns at once, the ones not cached are all found in a single pass over the module.
+		 *
+		 * @return One result per pattern, in the same order.
+		 */
+		std::vector<std::optional<handle>> scan(const module& mod, const std::vector<std::string>& idas, section_type types = section_type::executable);
+
+		/**
+		 * @brief Writes the cache files that got new results. Single pattern scans only update the memo, this persists them.
+		 */
+		void flush();
+
+	private:
+		struct module_entry
+		{
+			uint32_t m_timestamp;
+			size_t m_size;
+			std::unique_ptr<signature_cache> m_cache;
+		};
+
+		module_entry& get_entry(const module& mod);
+
+		std::mutex m_lock;
+		std::filesystem::path m_folder;
+		ankerl::unordered_dense::map<std::string, module_entry> m_modules;
+	};
+
+	inline auto g_pattern_cache = pattern_cache();
+} // namespace memory
@@ -0,0 +1,292 @@
+#include "pe.hpp"
+
+#include <algorithm>
+#include <cstring>
+
+namespace memory::pe
+{
+	const nt_headers64* read_nt_headers(const uint8_t* data, std::size_t size)
+	{
+		if (!data || size < sizeof(dos_header))
+		{
+			return nullptr;
+		}
+
+		const auto dos = reinterpret_cast<const dos_header*>(data);
+		if (dos->m_magic != dos_signature || dos->m_lfanew < 0 || size < static_cast<std::size_t>(dos->m_lfanew) + sizeof(nt_headers64))
+		{
+			return nullptr;
+		}
+
+		const auto nt = reinterpret_cast<const nt_headers64*>(data + dos->m_lfanew);
+		if (nt->m_signature != nt_signature || nt->m_optional_header.m_magic != optional_header_magic)
+		{
+			return nullptr;
+		}
+
+		return nt;
+	}
+
+	const section_header* first_section(const nt_headers64* nt_headers)
+	{
+		const auto optional_header = reinterpret_cast<const uint8_t*>(&nt_headers->m_optional_header);
+		return reinterpret_cast<const section_header*>(optional_header + nt_headers->m_file_header.m_size_of_optional_header);
+	}
+
+	std::vector<section_info> read_sections(const uint8_t* data, std::size_t size)
+	{
+		std::vector<section_info> sections;
+
+		const auto nt = read_nt_headers(data, size);
+		if (!nt)
+		{
+			return sections;
+		}
+
+		const auto headers    = first_section(nt);
+		const auto table_end  = reinterpret_cast<const uint8_t*>(headers + nt->m_file_header.m_number_of_sections);
+		const auto image_size = std::min<std::size_t>(size, nt->m_optional_header.m_size_of_image);
+		if (table_end > data + size)
+		{
+			return sections;
+		}
+
+		sections.reserve(nt->m_file_header.m_number_of_sections);
+		for (uint16_t i = 0; i < nt->m_file_header.m_number_of_sections; i++)
+		{
+			const auto& header = headers[i];
+
+			// Some linkers leave the virtual size empty.
+			const std::size_t virtual_size = header.m_virtual_size ? header.m_virtual_size : header.m_size_of_raw_data;
+			if (!virtual_size || header.m_virtual_address >= image_size)
+			{
+				continue;
+			}
+
+			section_type type;
+			if (header.m_characteristics & section_mem_execute)
+			{
+				type = section_type::executable;
+			}
+			else if (header.m_characteristics & section_mem_write)
+			{
+				type = section_type::writable_data;
+			}
+			else
+			{
+				type = section_type::read_only_data;
+			}
+
+			// The name is not null terminated when it uses all 8 characters.
+			sections.push_back({std::string(header.m_name, strnlen(header.m_name, section_name_size)),
+			                    header.m_virtual_address,
+			                    static_cast<uint32_t>(std::min(virtual_size, image_size - header.m_virtual_address)),
+			                    type});
+		}
+
+		std::ranges::sort(sections,
+		                  [](const section_info& a, const section_info& b)
+		                  {
+			                  return a.m_rva < b.m_rva;
+		                  });
+
+		return sections;
+	}
+
+	std::vector<uint32_t> read_relocations(const uint8_t* image, std::size_t size, uint32_t rva_begin, uint32_t rva_end)
+	{
+		std::vector<uint32_t> relocations;
+
+		const auto nt = read_nt_headers(image, size);
+		if (!nt || nt->m_optional_header.m_number_of_rva_and_sizes <= directory_basereloc)
+		{
+			return relocations;
+		}
+
+		const auto& directory = nt->m_optional_header.m_data_directory[directory_basereloc];
+		if (!directory.m_virtual_address || static_cast<std::size_t>(directory.m_virtual_address) + directory.m_size > size)
+		{
+			return relocations;
+		}
+
+		// One block per 4 KiB page.
+		auto block           = image + directory.m_virtual_address;
+		const auto block_end = block + directory.m_size;
+		while (block + sizeof(base_relocation_block) <= block_end)
+		{
+			const auto header = reinterpret_cast<const base_relocation_block*>(block);
+			if (header->m_size_of_block < sizeof(base_relocation_block) || block + header->m_size_of_block > block_end)
+			{
+				break;
+			}
+
+			if (header->m_virtual_address + 0x10'00 > rva_begin && header->m_virtual_address < rva_end)
+			{
+				const auto entries     = reinterpret_cast<const uint16_t*>(block + sizeof(base_relocation_block));
+				const auto entry_count = (header->m_size_of_block - sizeof(base_relocation_block)) / sizeof(uint16_t);
+				for (std::size_t i = 0; i < entry_count; i++)
+				{
+					const auto rva = header->m_virtual_address + (entries[i] & 0x0F'FF);
+					if ((entries[i] >> 12) == relocation_dir64 && rva >= rva_begin && rva < rva_end)
+					{
+						relocations.push_back(rva);
+					}
+				}
+			}
+
+			block += header->m_size_of_block;
+		}
+
+		std::ranges::sort(relocations);
+		return relocations;
+	}
+
+	std::vector<import_info> read_imports(const uint8_t* image, std::size_t size)
+	{
+		std::vector<import_info> imports;
+
+		const auto nt = read_nt_headers(image, size);
+		if (!nt || nt->m_optional_header.m_number_of_rva_and_sizes <= directory_import)
+		{
+			return imports;
+		}
+
+		const auto& directory = nt->m_optional_header.m_data_directory[directory_import];
+		if (!directory.m_virtual_address || static_cast<std::size_t>(directory.m_virtual_address) + directory.m_size > size)
+		{
+			return imports;
+		}
+
+		const auto c_string = [image, size](uint32_t rva) -> std::string
+		{
+			if (rva >= size)
+			{
+				return {};
+			}
+
+			const auto begin = reinterpret_cast<const char*>(image + rva);
+			return std::string(begin, strnlen(begin, size - rva));
+		};
+
+		// The directory ends with a zeroed descriptor.
+		for (auto rva = directory.m_virtual_address; rva + sizeof(import_descriptor) <= size; rva += sizeof(import_descriptor))
+		{
+			const auto descriptor = reinterpret_cast<const import_descriptor*>(image + rva);
+			if (!descriptor->m_name || !descriptor->m_first_thunk)
+			{
+				break;
+			}
+
+			const auto dll        = c_string(descriptor->m_name);
+			const auto lookup_rva = descriptor->m_original_first_thunk ? descriptor->m_original_first_thunk : descriptor->m_first_thunk;
+			for (uint32_t i = 0;; i++)
+			{
+				const auto thunk_rva = static_cast<std::size_t>(lookup_rva) + i * sizeof(uint64_t);
+				const auto slot_rva  = static_cast<std::size_t>(descriptor->m_first_thunk) + i * sizeof(uint64_t);
+				if (thunk_rva + sizeof(uint64_t) > size || slot_rva + sizeof(uint64_t) > size)
+				{
+					break;
+				}
+
+				uint64_t thunk;
+				std::memcpy(&thunk, image + thunk_rva, sizeof(thunk));
+				if (!thunk)
+				{
+					break;
+				}
+
+				import_info info{dll, {}, 0, static_cast<uint32_t>(slot_rva)};
+				if (thunk & import_ordinal_flag)
+				{
+					info.m_ordinal = static_cast<uint16_t>(thunk);
+				}
+				else if (thunk + sizeof(uint16_t) < size)
+				{
+					// IMAGE_IMPORT_BY_NAME: the export table hint, then the name.
+					info.m_name = c_string(static_cast<uint32_t>(thunk + sizeof(uint16_t)));
+				}
+
+				imports.push_back(std::move(info));
+			}
+		}
+
+		return imports;
+	}
+
+	std::span<const runtime_function> read_runtime_functions(const uint8_t* image, std::size_t size)
+	{
+		const auto nt = read_nt_headers(image, size);
+		if (!nt || nt->m_optional_header.m_number_of_rva_and_sizes <= directory_exception)
+		{
+			return {};
+		}
+
+		const auto& directory = nt->m_optional_header.m_data_directory[directory_exception];
+		if (!directory.m_virtual_address || static_cast<std::size_t>(directory.m_virtual_address) + directory.m_size > size)
+		{
+			return {};
+		}
+
+		return {reinterpret_cast<const runtime_function*>(image + directory.m_virtual_address), directory.m_size / sizeof(runtime_function)};
+	}
+
+	const runtime_function* find_runtime_function(std::span<const runtime_function> functions, uint32_t rva)
+	{
+		const auto it = std::ranges::upper_bound(functions, rva, std::less{}, &runtime_function::m_begin_address);
+		if (it == functions.begin())
+		{
+			return nullptr;
+		}
+
+		const auto& entry = *(it - 1);
+		return rva < entry.m_end_address ? &entry : nullptr;
+	}
+
+	const runtime_function* primary_runtime_function(const uint8_t* image, std::size_t size, std::span<const runtime_function> functions, const runtime_function* entry)
+	{
+		constexpr uint8_t unwind_flag_chain_info = 0x04;
+
+		// Chains are short, the bound only protects against a corrupted image.
+		for (int depth = 0; entry && depth < 32; depth++)
+		{
+			// Bit 0 set: the field is the rva of another RUNTIME_FUNCTION, whose unwind info is the one to read.
+			if (entry->m_unwind_info_address & 1)
+			{
+				const auto indirect = entry->m_unwind_info_address & ~1u;
+				if (static_cast<std::size_t>(indirect) + sizeof(runtime_function) > size)
+				{
+					return entry;
+				}
+
+				entry = reinterpret_cast<const runtime_function*>(image + indirect);
+				continue;
+			}
+
+			// UNWIND_INFO: version and flags, prolog size, unwind code count, frame register, then the 2 byte unwind codes.
+			const auto unwind_info = entry->m_unwind_info_address;
+			if (static_cast<std::size_t>(unwind_info) + 4 > size)
+			{
+				return entry;
+			}
+
+			const auto flags = image[unwind_info] >> 3;
+			if (!(flags & unwind_flag_chain_info))
+			{
+				return entry;
+			}
+
+			// The parent RUNTIME_FUNCTION follows the unwind codes, their count is rounded up to keep it 4 byte aligned.
+			const auto code_count = (image[unwind_info + 2] + 1u) & ~1u;
+			const auto parent     = unwind_info + 4 + code_count * 2;
+			if (static_cast<std::size_t>(parent) + sizeof(runtime_function) > size)
+			{
+				return entry;
+			}
+
+			const auto parent_begin = reinterpret_cast<const runtime_function*>(image + parent)->m_begin_address;
+			entry                   = find_runtime_function(functions, parent_begin);
+		}
+
+		return entry;
+	}
+} // namespace memory::pe
@@ -0,0 +1,247 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <string>
+#include <vector>
+
+namespace memory
+{
+	// Kind of PE section, can be combined to filter which sections a module scan covers.
+	enum class section_type : uint8_t
+	{
+		none           = 0,
+		executable     = 1 << 0,
+		read_only_data = 1 << 1,
+		writable_data  = 1 << 2,
+		// The whole image, headers and the padding between sections included.
+		all = executable | read_only_data | writable_data,
+	};
+
+	constexpr section_type operator|(section_type a, section_type b)
+	{
+		return static_cast<section_type>(static_cast<uint8_t>(a) | static_cast<uint8_t>(b));
+	}
+
+	constexpr bool has_section_type(section_type types, section_type type)
+	{
+		return (static_cast<uint8_t>(types) & static_cast<uint8_t>(type)) != 0;
+	}
+} // namespace memory
+
+/**
+ * @brief Portable PE32+ definitions, laid out exactly like the windows.h IMAGE_* structures.
+ * Lets the PE parsing run on images that are not loaded in the current process, and on non Windows hosts.
+ */
+namespace memory::pe
+{
+	inline constexpr uint16_t dos_signature          = 0x5A'4D;       // MZ
+	inline constexpr uint32_t nt_signature           = 0x00'00'45'50; // PE\0\0
+	inline constexpr uint16_t optional_header_magic  = 0x02'0B;       // PE32+
+	inline constexpr uint32_t section_mem_execute    = 0x20'00'00'00;
+	inline constexpr uint32_t section_mem_read       = 0x40'00'00'00;
+	inline constexpr uint32_t section_mem_write      = 0x80'00'00'00;
+	inline constexpr std::size_t section_name_size   = 8;
+	inline constexpr std::size_t data_directory_size = 16;
+
+	enum data_directory_index : uint8_t
+	{
+		directory_export    = 0,
+		directory_import    = 1,
+		directory_exception = 3,
+		directory_basereloc = 5,
+	};
+
+	// Import lookup table entries with this bit import by ordinal, by name otherwise.
+	inline constexpr uint64_t import_ordinal_flag = 0x80'00'00'00'00'00'00'00;
+
+	// Base relocation entry type patching a full 64-bit address.
+	inline constexpr uint8_t relocation_dir64 = 10;
+
+#pragma pack(push, 4)
+	struct dos_header
+	{
+		uint16_t m_magic;
+		uint8_t m_unused[58];
+		int32_t m_lfanew;
+	};
+
+	struct file_header
+	{
+		uint16_t m_machine;
+		uint16_t m_number_of_sections;
+		uint32_t m_time_date_stamp;
+		uint32_t m_pointer_to_symbol_table;
+		uint32_t m_number_of_symbols;
+		uint16_t m_size_of_optional_header;
+		uint16_t m_characteristics;
+	};
+
+	struct data_directory
+	{
+		uint32_t m_virtual_address;
+		uint32_t m_size;
+	};
+
+	struct optional_header64
+	{
+		uint16_t m_magic;
+		uint8_t m_major_linker_version;
+		uint8_t m_minor_linker_version;
+		uint32_t m_size_of_code;
+		uint32_t m_size_of_initialized_data;
+		uint32_t m_size_of_uninitialized_data;
+		uint32_t m_address_of_entry_point;
+		uint32_t m_base_of_code;
+		uint64_t m_image_base;
+		uint32_t m_section_alignment;
+		uint32_t m_file_alignment;
+		uint16_t m_os_and_image_and_subsystem_versions[6];
+		uint32_t m_win32_version_value;
+		uint32_t m_size_of_image;
+		uint32_t m_size_of_headers;
+		uint32_t m_checksum;
+		uint16_t m_subsystem;
+		uint16_t m_dll_characteristics;
+		uint64_t m_stack_and_heap_sizes[4];
+		uint32_t m_loader_flags;
+		uint32_t m_number_of_rva_and_sizes;
+		data_directory m_data_directory[data_directory_size];
+	};
+
+	struct nt_headers64
+	{
+		uint32_t m_signature;
+		file_header m_file_header;
+		optional_header64 m_optional_header;
+	};
+
+	struct section_header
+	{
+		char m_name[section_name_size];
+		uint32_t m_virtual_size;
+		uint32_t m_virtual_address;
+		uint32_t m_size_of_raw_data;
+		uint32_t m_pointer_to_raw_data;
+		uint32_t m_pointer_to_relocations;
+		uint32_t m_pointer_to_linenumbers;
+		uint16_t m_number_of_relocations;
+		uint16_t m_number_of_linenumbers;
+		uint32_t m_characteristics;
+	};
+
+	// RUNTIME_FUNCTION, one per function (or function fragment) in the exception directory.
+	struct runtime_function
+	{
+		uint32_t m_begin_address;
+		uint32_t m_end_address;
+		uint32_t m_unwind_info_address;
+	};
+
+	struct base_relocation_block
+	{
+		uint32_t m_virtual_address;
+		uint32_t m_size_of_block;
+		// Followed by uint16_t entries: type in the top 4 bits, page offset in the low 12.
+	};
+
+	struct export_directory
+	{
+		uint32_t m_characteristics;
+		uint32_t m_time_date_stamp;
+		uint16_t m_major_version;
+		uint16_t m_minor_version;
+		uint32_t m_name;
+		uint32_t m_base;
+		uint32_t m_number_of_functions;
+		uint32_t m_number_of_names;
+		uint32_t m_address_of_functions;
+		uint32_t m_address_of_names;
+		uint32_t m_address_of_name_ordinals;
+	};
+
+	struct import_descriptor
+	{
+		// Import lookup table, holding the names. 0 for old linkers, which only emit the IAT.
+		uint32_t m_original_first_thunk;
+		uint32_t m_time_date_stamp;
+		uint32_t m_forwarder_chain;
+		uint32_t m_name;
+		// Import address table, overwritten with the resolved addresses by the loader.
+		uint32_t m_first_thunk;
+	};
+#pragma pack(pop)
+
+	static_assert(sizeof(dos_header) == 64);
+	static_assert(sizeof(file_header) == 20);
+	static_assert(sizeof(optional_header64) == 240);
+	static_assert(sizeof(nt_headers64) == 264);
+	static_assert(sizeof(section_header) == 40);
+	static_assert(sizeof(export_directory) == 40);
+	static_assert(sizeof(import_descriptor) == 20);
+	static_assert(sizeof(base_relocation_block) == 8);
+	static_assert(sizeof(runtime_function) == 12);
+
+	struct section_info
+	{
+		std::string m_name;
+		uint32_t m_rva;
+		uint32_t m_size;
+		section_type m_type;
+	};
+
+	/**
+	 * @brief Validates the DOS and NT headers at the start of the buffer. The headers of a raw file and of a mapped image are identical.
+	 *
+	 * @param size Readable size of the buffer.
+	 * @return nullptr if the buffer is not a PE32+ image.
+	 */
+	const nt_headers64* read_nt_headers(const uint8_t* data, std::size_t size);
+
+	const section_header* first_section(const nt_headers64* nt_headers);
+
+	/**
+	 * @brief Sections of an image, sorted by rva and clamped to the image size.
+	 * Sections without any virtual size are skipped.
+	 */
+	std::vector<section_info> read_sections(const uint8_t* data, std::size_t size);
+
+	/**
+	 * @brief rvas of the 64-bit base relocations located in [rva_begin, rva_end), sorted. Only works on images laid out at their rvas.
+	 */
+	std::vector<uint32_t> read_relocations(const uint8_t* image, std::size_t size, uint32_t rva_begin, uint32_t rva_end);
+
+	struct import_info
+	{
+		std::string m_dll;
+		// Empty for imports by ordinal.
+		std::string m_name;
+		uint16_t m_ordinal;
+		// IAT slot the loader writes the address of the import to.
+		uint32_t m_slot_rva;
+	};
+
+	/**
+	 * @brief Every import of an image laid out at its rvas, in import directory order. Works on a loaded module and on a pe_image,
+	 * the names are read from the import lookup table which the loader leaves untouched.
+	 */
+	std::vector<import_info> read_imports(const uint8_t* image, std::size_t size);
+
+	/**
+	 * @brief Exception directory (.pdata) of an image laid out at its rvas. The linker already sorts it by begin address, so it is used in place.
+	 */
+	std::span<const runtime_function> read_runtime_functions(const uint8_t* image, std::size_t size);
+
+	/**
+	 * @brief Binary search for the entry whose [begin, end) contains the rva.
+	 *
+	 * @return nullptr for leaf functions, which have no entry, and addresses outside of any function.
+	 */
+	const runtime_function* find_runtime_function(std::span<const runtime_function> functions, uint32_t rva);
+
+	/**
+	 * @brief Follows chained unwind info (functions split in several fragments) back to the entry of the function start.
+	 * Indirect entries, pointing to another RUNTIME_FUNCTION instead of an UNWIND_INFO, are followed too.
+	 */
+	const runtime_function* primary_runtime_function(const uint8_t* image, std::size_t size, std::span<const runtime_function> functions, const runtime_function* entry);
+} // namespace memory::pe
@@ -0,0 +1,175 @@
+#include "pe_image.hpp"
+
+#include <algorithm>
+#include <cstring>
+
+#if defined(_WIN32)
+	#include <Windows.h>
+#else
+	#include <fcntl.h>
+	#include <sys/mman.h>
+	#include <sys/stat.h>
+	#include <unistd.h>
+#endif
+
+namespace memory
+{
+	// Read only view of a whole file, unmapped when destroyed.
+	class mapped_file
+	{
+	public:
+		explicit mapped_file(const std::filesystem::path& path)
+		{
+#if defined(_WIN32)
+			const auto file = CreateFileW(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+			if (file == INVALID_HANDLE_VALUE)
+			{
+				return;
+			}
+
+			LARGE_INTEGER file_size{};
+			// The view keeps the mapping alive, neither handle is needed past this point.
+			const auto mapping = GetFileSizeEx(file, &file_size) && file_size.QuadPart ? CreateFileMappingW(file, nullptr, PAGE_READONLY, 0, 0, nullptr) : nullptr;
+			CloseHandle(file);
+			if (!mapping)
+			{
+				return;
+			}
+
+			m_data = static_cast<const uint8_t*>(MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0));
+			m_size = m_data ? static_cast<std::size_t>(file_size.QuadPart) : 0;
+			CloseHandle(mapping);
+#else
+			const auto file = open(path.c_str(), O_RDONLY);
+			if (file < 0)
+			{
+				return;
+			}
+
+			struct stat status{};
+			if (fstat(file, &status) == 0 && status.st_size > 0)
+			{
+				const auto view = mmap(nullptr, static_cast<std::size_t>(status.st_size), PROT_READ, MAP_PRIVATE, file, 0);
+				if (view != MAP_FAILED)
+				{
+					m_data = static_cast<const uint8_t*>(view);
+					m_size = static_cast<std::size_t>(status.st_size);
+				}
+			}
+			close(file);
+#endif
+		}
+
+		~mapped_file()
+		{
+			if (!m_data)
+			{
+				return;
+			}
+
+#if defined(_WIN32)
+			UnmapViewOfFile(m_data);
+#else
+			munmap(const_cast<uint8_t*>(m_data), m_size);
+#endif
+		}
+
+		mapped_file(const mapped_file&)            = delete;
+		mapped_file& operator=(const mapped_file&) = delete;
+
+		const uint8_t* data() const
+		{
+			return m_data;
+		}
+
+		std::size_t size() const
+		{
+			return m_size;
+		}
+
+	private:
+		const uint8_t* m_data{};
+		std::size_t m_size{};
+	};
+	pe_image::pe_image(const std::filesystem::path& path)
+	{
+		m_loaded = load(path);
+		if (!m_loaded)
+		{
+			m_image.clear();
+			m_sections.clear();
+		}
+	}
+
+	bool pe_image::load(const std::filesystem::path& path)
+	{
+		// Only the image layout is allocated, the file itself is read through the mapping.
+		const mapped_file raw(path);
+		if (!raw.data())
+		{
+			return false;
+		}
+
+		const auto nt = pe::read_nt_headers(raw.data(), raw.size());
+		if (!nt)
+		{
+			return false;
+		}
+
+		const auto& optional_header = nt->m_optional_header;
+		const auto headers_size     = std::min<std::size_t>({optional_header.m_size_of_headers, optional_header.m_size_of_image, raw.size()});
+
+		m_image.assign(optional_header.m_size_of_image, 0);
+		m_timestamp = nt->m_file_header.m_time_date_stamp;
+		std::memcpy(m_image.data(), raw.data(), headers_size);
+
+		const auto headers = pe::first_section(nt);
+		if (reinterpret_cast<const uint8_t*>(headers + nt->m_file_header.m_number_of_sections) > raw.data() + raw.size())
+		{
+			return false;
+		}
+
+		for (uint16_t i = 0; i < nt->m_file_header.m_number_of_sections; i++)
+		{
+			const auto& header = headers[i];
+			if (header.m_virtual_address >= m_image.size() || header.m_pointer_to_raw_data >= raw.size())
+			{
+				continue;
+			}
+
+			// Anything past the raw data is zero filled, same as the loader does for .bss style sections.
+			const std::size_t virtual_size = header.m_virtual_size ? header.m_virtual_size : header.m_size_of_raw_data;
+			const auto copy_size           = std::min<std::size_t>({header.m_size_of_raw_data, virtual_size, raw.size() - header.m_pointer_to_raw_data, m_image.size() - header.m_virtual_address});
+			std::memcpy(m_image.data() + header.m_virtual_address, raw.data() + header.m_pointer_to_raw_data, copy_size);
+		}
+
+		m_sections = pe::read_sections(m_image.data(), m_image.size());
+
+		return true;
+	}
+
+	bool pe_image::loaded() const
+	{
+		return m_loaded;
+	}
+
+	const uint8_t* pe_image::base() const
+	{
+		return m_image.data();
+	}
+
+	std::size_t pe_image::size() const
+	{
+		return m_image.size();
+	}
+
+	uint32_t pe_image::timestamp() const
+	{
+		return m_timestamp;
+	}
+
+	const std::vector<pe::section_info>& pe_image::sections() const
+	{
+		return m_sections;
+	}
+} // namespace memory
@@ -0,0 +1,38 @@
+#pragma once
+#include "pe.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <vector>
+
+namespace memory
+{
+	/**
+	 * @brief PE file from disk laid out like the loader would map it: headers at offset 0 and every section at its rva.
+	 * Nothing is executed, relocated or imported, so this works on any host for scanning and offline analysis.
+	 * The file is read through a read only mapping, released once the sections are copied at their rvas: file offsets and
+	 * rvas differ, so the mapping can't be scanned as is. The image is never written to after loading. Wrap it in a memory::range(image.base(), image.size()) to scan it like a live module.
+	 */
+	class pe_image
+	{
+	public:
+		explicit pe_image(const std::filesystem::path& path);
+
+		bool loaded() const;
+
+		const uint8_t* base() const;
+		std::size_t size() const;
+		uint32_t timestamp() const;
+
+		const std::vector<pe::section_info>& sections() const;
+
+	private:
+		bool load(const std::filesystem::path& path);
+
+		std::vector<uint8_t> m_image;
+		uint32_t m_timestamp{};
+		std::vector<pe::section_info> m_sections;
+		bool m_loaded{};
+	};
+} // namespace memory
@@ -1,6 +1,14 @@
 #include "range.hpp"
 
+#include "multi_pattern.hpp"
 #include "pattern.hpp"
+#include "scanner.hpp"
+#include "threads/thread_pool.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <future>
+#include <thread>
 
 namespace memory
 {
@@ -30,99 +38,204 @@ namespace memory
 		return h.as<std::uintptr_t>() >= begin().as<std::uintptr_t>() && h.as<std::uintptr_t>() <= end().as<std::uintptr_t>();
 	}
 
-	// https://en.wikipedia.org/wiki/Boyer%E2%80%93Moore%E2%80%93Horspool_algorithm
-	// https://www.youtube.com/watch?v=AuZUeshhy-s
-	std::optional<handle> scan_pattern(const std::optional<uint8_t>* sig, std::size_t length, handle begin, std::size_t module_size)
+	std::optional<handle> range::scan(const pattern& sig) const
 	{
-		std::size_t maxShift = length;
-		std::size_t max_idx  = length - 1;
+		return scan(sig.view());
+	}
 
-		//Get wildcard index, and store max shiftable byte count
-		std::size_t wild_card_idx{static_cast<size_t>(-1)};
-		for (int i{static_cast<int>(max_idx - 1)}; i >= 0; --i)
+	std::optional<handle> range::scan(const scanner::pattern_view& sig) const
+	{
+		const auto offset = scanner::find_first(m_base.as<const uint8_t*>(), m_size, sig);
+		if (offset == scanner::npos)
 		{
-			if (!sig[i])
-			{
-				maxShift      = max_idx - i;
-				wild_card_idx = i;
-				break;
-			}
+			return std::nullopt;
 		}
 
-		//Store max shiftable bytes for non wildcards.
-		std::size_t shift_table[UINT8_MAX + 1]{};
-		for (std::size_t i{}; i <= UINT8_MAX; ++i)
-		{
-			shift_table[i] = maxShift;
-		}
+		return m_base.add(offset);
+	}
 
-		//Fill shift table with sig bytes
-		for (std::size_t i{wild_card_idx + 1}; i != max_idx; ++i)
+	std::optional<handle> range::scan_parallel(const pattern& sig) const
+	{
+		return scan_parallel(sig.view());
+	}
+
+	std::optional<handle> range::scan_parallel(const scanner::pattern_view& view) const
+	{
+		// Below this a single core is faster than waking up the pool.
+		constexpr std::size_t min_chunk_size = 0x4'00'00;
+
+		if (!big::g_thread_pool || !view.m_size || m_size < view.m_size || m_size < min_chunk_size * 2)
 		{
-			shift_table[*sig[i]] = max_idx - i;
+			return scan(view);
 		}
 
-		//Loop data
-		const auto scan_end = module_size - length;
-		for (std::size_t current_idx{}; current_idx <= scan_end;)
+		// A few chunks per core so that the chunks after a match can be skipped early.
+		const auto candidate_count = m_size - view.m_size + 1;
+		const auto thread_count    = std::max(1u, std::thread::hardware_concurrency());
+		const auto chunk_size      = std::max(min_chunk_size, candidate_count / (thread_count * 4) + 1);
+		const auto chunk_count     = (candidate_count + chunk_size - 1) / chunk_size;
+
+		const auto data = m_base.as<const uint8_t*>();
+		std::atomic<std::size_t> best_offset{scanner::npos};
+
+		big::g_thread_pool->parallel_for(chunk_count,
+		                                 [&](size_t chunk)
+		                                 {
+			                                 const auto chunk_begin = chunk * chunk_size;
+			                                 // Chunks are handed out in order, a match in an earlier chunk always wins.
+			                                 if (chunk_begin >= best_offset.load(std::memory_order_relaxed))
+			                                 {
+				                                 return;
+			                                 }
+
+			                                 // Chunks overlap by the pattern size - 1 so that matches crossing a boundary are found.
+			                                 const auto chunk_candidates = std::min(chunk_size, candidate_count - chunk_begin);
+			                                 const auto offset = scanner::find_first(data + chunk_begin, chunk_candidates + view.m_size - 1, view);
+			                                 if (offset == scanner::npos)
+			                                 {
+				                                 return;
+			                                 }
+
+			                                 auto current = best_offset.load();
+			                                 while (chunk_begin + offset < current && !best_offset.compare_exchange_weak(current, chunk_begin + offset))
+			                                 {
+			                                 }
+		                                 });
+
+		if (best_offset == scanner::npos)
 		{
-			for (std::ptrdiff_t sig_idx{(std::ptrdiff_t)max_idx}; sig_idx >= 0; --sig_idx)
-			{
-				if (sig[sig_idx] && *begin.add(current_idx + sig_idx).as<uint8_t*>() != *sig[sig_idx])
-				{
-					current_idx += shift_table[*begin.add(current_idx + max_idx).as<uint8_t*>()];
-					break;
-				}
-				else if (sig_idx == NULL)
-				{
-					return begin.add(current_idx);
-				}
-			}
+			return std::nullopt;
 		}
-		return std::nullopt;
+
+		return m_base.add(best_offset.load());
 	}
 
-	std::optional<handle> range::scan(const pattern& sig) const
+	std::vector<handle> range::scan_all(const pattern& sig) const
+	{
+		std::vector<handle> result{};
+		scan_all(sig, result);
+		return result;
+	}
+
+	void range::scan_all(const pattern& sig, std::vector<handle>& out) const
+	{
+		scan_all(sig.view(), out);
+	}
+
+	void range::scan_all(const scanner::pattern_view& view, std::vector<handle>& out) const
 	{
-		auto data   = sig.m_bytes.data();
-		auto length = sig.m_bytes.size();
+		constexpr std::size_t min_chunk_size = 0x4'00'00;
 
-		if (auto result = scan_pattern(data, length, m_base, m_size); result)
+		out.clear();
+
+		if (!view.m_size || m_size < view.m_size)
 		{
-			return result;
+			return;
 		}
 
-		return std::nullopt;
-	}
+		const auto data            = m_base.as<const uint8_t*>();
+		const auto candidate_count = m_size - view.m_size + 1;
+		const auto thread_count    = big::g_thread_pool ? std::max(1u, std::thread::hardware_concurrency()) : 1u;
+		const auto chunk_size      = std::max(min_chunk_size, candidate_count / thread_count + 1);
+		const auto chunk_count     = (candidate_count + chunk_size - 1) / chunk_size;
 
-	bool pattern_matches(uint8_t* target, const std::optional<uint8_t>* sig, std::size_t length)
-	{
-		for (std::size_t i{}; i != length; ++i)
+		// Each chunk owns the matches starting inside it, they only need to be concatenated afterwards.
+		// Scratch of the calling thread, reused between calls so the chunks keep the capacity of the previous scans.
+		thread_local std::vector<std::vector<std::size_t>> t_chunk_offsets;
+		if (t_chunk_offsets.size() < chunk_count)
+		{
+			t_chunk_offsets.resize(chunk_count);
+		}
+		for (std::size_t chunk = 0; chunk < chunk_count; ++chunk)
 		{
-			if (sig[i] && *sig[i] != target[i])
+			t_chunk_offsets[chunk].clear();
+		}
+		// The pool workers must fill the buffers of this thread, not their own thread_local instance.
+		auto& chunk_offsets = t_chunk_offsets;
+
+		const auto scan_chunk = [&](size_t chunk)
+		{
+			const auto chunk_begin      = chunk * chunk_size;
+			const auto chunk_candidates = std::min(chunk_size, candidate_count - chunk_begin);
+			scanner::find_all(data + chunk_begin, chunk_candidates + view.m_size - 1, view, chunk_offsets[chunk]);
+		};
+
+		if (chunk_count == 1)
+		{
+			scan_chunk(0);
+		}
+		else
+		{
+			big::g_thread_pool->parallel_for(chunk_count, scan_chunk);
+		}
+
+		std::size_t total = 0;
+		for (std::size_t chunk = 0; chunk < chunk_count; ++chunk)
+		{
+			total += chunk_offsets[chunk].size();
+		}
+
+		out.resize(total, m_base);
+
+		auto it = out.begin();
+		for (std::size_t chunk = 0; chunk < chunk_count; ++chunk)
+		{
+			const auto chunk_begin = chunk * chunk_size;
+			for (const auto offset : chunk_offsets[chunk])
 			{
-				return false;
+				*it++ = m_base.add(chunk_begin + offset);
 			}
 		}
-
-		return true;
 	}
 
-	std::vector<handle> range::scan_all(const pattern& sig) const
+	std::vector<std::size_t> range::scan_first(const scanner::multi_pattern& matcher, std::size_t thread_count) const
 	{
-		std::vector<handle> result{};
-		auto data   = sig.m_bytes.data();
-		auto length = sig.m_bytes.size();
+		constexpr std::size_t min_chunk_size = 0x10'00'00;
 
-		const auto scan_end = m_size - length;
-		for (std::uintptr_t i{}; i != scan_end; ++i)
+		const auto data        = m_base.as<const uint8_t*>();
+		const auto chunk_count = std::clamp<std::size_t>(m_size / min_chunk_size, 1, std::max<std::size_t>(thread_count, 1));
+		const auto chunk_size  = m_size / chunk_count + 1;
+
+		// Every chunk owns the anchors inside of it, the lowest match of each pattern wins.
+		std::vector<std::vector<std::size_t>> chunk_offsets(chunk_count);
+		const auto scan_chunk = [&](size_t chunk)
+		{
+			chunk_offsets[chunk] = matcher.find_first(data, m_size, chunk * chunk_size, (chunk + 1) * chunk_size);
+		};
+
+		if (chunk_count == 1)
+		{
+			scan_chunk(0);
+		}
+		else if (big::g_thread_pool)
+		{
+			big::g_thread_pool->parallel_for(chunk_count, scan_chunk);
+		}
+		else
+		{
+			// Batches can run before the pool exists.
+			std::vector<std::future<void>> futures;
+			for (std::size_t chunk = 1; chunk < chunk_count; ++chunk)
+			{
+				futures.push_back(std::async(std::launch::async, scan_chunk, chunk));
+			}
+
+			scan_chunk(0);
+			for (auto& future : futures)
+			{
+				future.get();
+			}
+		}
+
+		auto offsets = std::move(chunk_offsets[0]);
+		for (std::size_t chunk = 1; chunk < chunk_count; ++chunk)
 		{
-			if (pattern_matches(m_base.add(i).as<uint8_t*>(), data, length))
+			for (std::size_t i = 0; i < offsets.size(); ++i)
 			{
-				result.push_back(m_base.add(i));
+				offsets[i] = std::min(offsets[i], chunk_offsets[chunk][i]);
 			}
 		}
 
-		return result;
+		return offsets;
 	}
 } // namespace memory
@@ -1,10 +1,10 @@
 #pragma once
 #include "fwddec.hpp"
 #include "handle.hpp"
+#include "scanner.hpp"
 
 #include <optional>
 #include <vector>
-#include <windows.h>
 
 namespace memory
 {
@@ -19,12 +19,28 @@ namespace memory
 
 		bool contains(handle h) const;
 
+		// The pattern_view overloads take already compiled patterns, such as a static_pattern, without any parsing or allocation.
 		std::optional<handle> scan(const pattern& sig) const;
+		std::optional<handle> scan(const scanner::pattern_view& sig) const;
+		// Same result as scan, but the range is split in chunks scanned on the thread pool. Only pays off on large ranges.
+		std::optional<handle> scan_parallel(const pattern& sig) const;
+		std::optional<handle> scan_parallel(const scanner::pattern_view& sig) const;
 		std::vector<handle> scan_all(const pattern& sig) const;
+		// Fills out with every match in increasing address order. out is cleared first, its capacity is kept so it can be reused.
+		void scan_all(const pattern& sig, std::vector<handle>& out) const;
+		void scan_all(const scanner::pattern_view& sig, std::vector<handle>& out) const;
+
+		/**
+		 * @brief First match of every pattern of the matcher, all found during the same pass over the range.
+		 * The pass is split in chunks on up to thread_count threads, the thread pool ones when there is a pool.
+		 *
+		 * @return Offset from begin() of the first match of each pattern, npos for the ones not found.
+		 */
+		std::vector<std::size_t> scan_first(const scanner::multi_pattern& matcher, std::size_t thread_count) const;
 
 	protected:
 		handle m_base;
 		std::size_t m_size;
-		DWORD m_timestamp;
+		uint32_t m_timestamp;
 	};
 } // namespace memory
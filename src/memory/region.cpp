@@ -0,0 +1,207 @@
+#include "region.hpp"
+
+#include "threads/thread_pool.hpp"
+
+#include <algorithm>
+#include <thread>
+
+#if defined(_WIN32)
+	#include <Windows.h>
+#else
+	#include <cstdio>
+	#include <cstring>
+#endif
+
+namespace memory
+{
+	static bool matches_filter(const region& region, const region_filter& filter)
+	{
+		if (!has_region_protection(region.m_protection, filter.m_required))
+		{
+			return false;
+		}
+
+		if (static_cast<uint8_t>(region.m_protection) & static_cast<uint8_t>(filter.m_excluded))
+		{
+			return false;
+		}
+
+		return filter.m_include_images || !region.m_image;
+	}
+
+#if defined(_WIN32)
+	static region_protection to_region_protection(DWORD protect)
+	{
+		switch (protect & 0xFF)
+		{
+		case PAGE_READONLY:          return region_protection::read;
+		case PAGE_READWRITE:
+		case PAGE_WRITECOPY:         return region_protection::read | region_protection::write;
+		case PAGE_EXECUTE:           return region_protection::execute;
+		case PAGE_EXECUTE_READ:      return region_protection::read | region_protection::execute;
+		case PAGE_EXECUTE_READWRITE:
+		case PAGE_EXECUTE_WRITECOPY: return region_protection::read | region_protection::write | region_protection::execute;
+		default:                     return region_protection::none;
+		}
+	}
+
+	std::vector<region> enumerate_regions(const region_filter& filter)
+	{
+		std::vector<region> regions;
+
+		MEMORY_BASIC_INFORMATION info{};
+		for (auto address = static_cast<uintptr_t>(0); VirtualQuery(reinterpret_cast<void*>(address), &info, sizeof(info)) == sizeof(info);
+		     address = reinterpret_cast<uintptr_t>(info.BaseAddress) + info.RegionSize)
+		{
+			if (info.State != MEM_COMMIT || (info.Protect & PAGE_GUARD) || (info.Protect & PAGE_NOACCESS))
+			{
+				continue;
+			}
+
+			const region region{reinterpret_cast<uintptr_t>(info.BaseAddress), info.RegionSize, to_region_protection(info.Protect), info.Type == MEM_IMAGE};
+			if (matches_filter(region, filter))
+			{
+				regions.push_back(region);
+			}
+		}
+
+		return regions;
+	}
+
+	// No C++ objects with destructors here, SEH and unwinding can't share a function.
+	bool run_guarded(void (*func)(void* context), void* context)
+	{
+		__try
+		{
+			func(context);
+			return true;
+		}
+		__except (GetExceptionCode() == EXCEPTION_ACCESS_VIOLATION ? EXCEPTION_EXECUTE_HANDLER : EXCEPTION_CONTINUE_SEARCH)
+		{
+			return false;
+		}
+	}
+#else
+	std::vector<region> enumerate_regions(const region_filter& filter)
+	{
+		std::vector<region> regions;
+
+		const auto maps = std::fopen("/proc/self/maps", "r");
+		if (!maps)
+		{
+			return regions;
+		}
+
+		char line[512];
+		while (std::fgets(line, sizeof(line), maps))
+		{
+			unsigned long long begin, end, offset;
+			char permissions[5]{};
+			unsigned int inode_major, inode_minor;
+			unsigned long long inode;
+			if (std::sscanf(line, "%llx-%llx %4s %llx %x:%x %llu", &begin, &end, permissions, &offset, &inode_major, &inode_minor, &inode) != 7)
+			{
+				continue;
+			}
+
+			// The vvar pages of the kernel are readable on paper but raise SIGBUS when some of them get read.
+			if (std::strstr(line, "[vvar"))
+			{
+				continue;
+			}
+
+			auto protection = region_protection::none;
+			protection      = permissions[0] == 'r' ? protection | region_protection::read : protection;
+			protection      = permissions[1] == 'w' ? protection | region_protection::write : protection;
+			protection      = permissions[2] == 'x' ? protection | region_protection::execute : protection;
+			if (protection == region_protection::none)
+			{
+				continue;
+			}
+
+			const region region{static_cast<uintptr_t>(begin), static_cast<std::size_t>(end - begin), protection, inode != 0};
+			if (matches_filter(region, filter))
+			{
+				regions.push_back(region);
+			}
+		}
+
+		std::fclose(maps);
+		return regions;
+	}
+
+	bool run_guarded(void (*func)(void* context), void* context)
+	{
+		func(context);
+		return true;
+	}
+#endif
+
+	void scan_regions(const scanner::pattern_view& sig, std::vector<handle>& out, const region_filter& filter, std::size_t max_results)
+	{
+		constexpr std::size_t chunk_size = 0x40'00'00;
+
+		out.clear();
+		if (!sig.m_size)
+		{
+			return;
+		}
+
+		struct scan_chunk
+		{
+			uintptr_t m_begin;
+			std::size_t m_candidates;
+		};
+
+		// Each chunk owns the matches starting inside it, the regions are already sorted.
+		std::vector<scan_chunk> chunks;
+		for (const auto& region : enumerate_regions(filter))
+		{
+			if (region.m_size < sig.m_size)
+			{
+				continue;
+			}
+
+			const auto candidate_count = region.m_size - sig.m_size + 1;
+			for (std::size_t begin = 0; begin < candidate_count; begin += chunk_size)
+			{
+				chunks.push_back({region.m_base + begin, std::min(chunk_size, candidate_count - begin)});
+			}
+		}
+
+		std::vector<std::vector<std::size_t>> chunk_offsets(chunks.size());
+		const auto scan = [&](size_t i)
+		{
+			auto find_all = [&]
+			{
+				scanner::find_all(reinterpret_cast<const uint8_t*>(chunks[i].m_begin), chunks[i].m_candidates + sig.m_size - 1, sig, chunk_offsets[i]);
+			};
+			run_guarded(find_all);
+		};
+
+		if (chunks.size() > 1 && big::g_thread_pool)
+		{
+			big::g_thread_pool->parallel_for(chunks.size(), scan);
+		}
+		else
+		{
+			for (size_t i = 0; i < chunks.size(); i++)
+			{
+				scan(i);
+			}
+		}
+
+		for (size_t i = 0; i < chunks.size() && out.size() < max_results; i++)
+		{
+			for (const auto offset : chunk_offsets[i])
+			{
+				if (out.size() == max_results)
+				{
+					break;
+				}
+
+				out.push_back(handle(chunks[i].m_begin + offset));
+			}
+		}
+	}
+} // namespace memory
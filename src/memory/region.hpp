@@ -0,0 +1,81 @@
+#pragma once
+#include "handle.hpp"
+#include "scanner.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <vector>
+
+namespace memory
+{
+	enum class region_protection : uint8_t
+	{
+		none    = 0,
+		read    = 1 << 0,
+		write   = 1 << 1,
+		execute = 1 << 2,
+	};
+
+	constexpr region_protection operator|(region_protection a, region_protection b)
+	{
+		return static_cast<region_protection>(static_cast<uint8_t>(a) | static_cast<uint8_t>(b));
+	}
+
+	constexpr bool has_region_protection(region_protection protection, region_protection flags)
+	{
+		return (static_cast<uint8_t>(protection) & static_cast<uint8_t>(flags)) == static_cast<uint8_t>(flags);
+	}
+
+	struct region
+	{
+		uintptr_t m_base;
+		std::size_t m_size;
+		region_protection m_protection;
+		// Mapped from a module file, as opposed to heap, stack or other private memory.
+		bool m_image;
+	};
+
+	struct region_filter
+	{
+		// Every one of these flags is needed.
+		region_protection m_required = region_protection::read;
+		// None of these flags is allowed.
+		region_protection m_excluded = region_protection::none;
+		bool m_include_images        = true;
+	};
+
+	/**
+	 * @brief Committed regions of the current process matching the filter, sorted by address.
+	 * Uses VirtualQuery on Windows and /proc/self/maps elsewhere. Guard and no access pages, and the kernel vvar pages, are never returned.
+	 */
+	std::vector<region> enumerate_regions(const region_filter& filter = {});
+
+	/**
+	 * @brief Calls func, catching the access violation it raises if the memory it reads gets freed meanwhile. Only guarded on Windows.
+	 *
+	 * @return false if func faulted. Objects func was building may be left half filled.
+	 */
+	bool run_guarded(void (*func)(void* context), void* context);
+
+	template<typename F>
+	bool run_guarded(F& func)
+	{
+		return run_guarded(
+		    [](void* context)
+		    {
+			    (*static_cast<F*>(context))();
+		    },
+		    &func);
+	}
+
+	/**
+	 * @brief Every match of the pattern in the regions matching the filter, in increasing address order.
+	 *
+	 * Regions are split in chunks scanned on the thread pool. Memory can be freed by other threads during the scan,
+	 * on Windows a region that stops being readable only ends its own chunk early.
+	 *
+	 * @param max_results The result is truncated to this many matches.
+	 */
+	void scan_regions(const scanner::pattern_view& sig, std::vector<handle>& out, const region_filter& filter = {}, std::size_t max_results = std::numeric_limits<std::size_t>::max());
+} // namespace memory
@@ -0,0 +1,219 @@
+#include "rtti_index.hpp"
+
+#include <algorithm>
+#include <cstring>
+#include <ranges>
+
+namespace memory
+{
+	// RTTICompleteObjectLocator of 64-bit images, the descriptor fields are rvas.
+	struct complete_object_locator
+	{
+		uint32_t m_signature;
+		uint32_t m_offset;
+		uint32_t m_constructor_displacement_offset;
+		uint32_t m_type_descriptor_rva;
+		uint32_t m_class_descriptor_rva;
+		uint32_t m_self_rva;
+	};
+	static_assert(sizeof(complete_object_locator) == 24);
+
+	// TypeDescriptor: type_info vtable and cached undecorated name pointers, then the NUL terminated mangled name.
+	static constexpr uint32_t type_descriptor_name_offset = 16;
+	static constexpr std::size_t max_type_name_length     = 4'096;
+
+	template<typename T>
+	static T read(const uint8_t* image, uint32_t rva)
+	{
+		T value;
+		std::memcpy(&value, image + rva, sizeof(T));
+		return value;
+	}
+
+	static bool is_type_descriptor(const uint8_t* image, std::size_t image_size, uint32_t rva)
+	{
+		const auto name = static_cast<std::size_t>(rva) + type_descriptor_name_offset;
+		if (name + 4 > image_size || std::memcmp(image + name, ".?A", 3) != 0)
+		{
+			return false;
+		}
+
+		const auto available = std::min(image_size - name, max_type_name_length);
+		return std::memchr(image + name, 0, available) != nullptr;
+	}
+
+	rtti_index::rtti_index(const uint8_t* image, std::size_t image_size, uint64_t image_base, const std::vector<pe::section_info>& sections) :
+	    m_image(image)
+	{
+		std::vector<pe::section_info> read_only;
+		for (const auto& section : sections)
+		{
+			if (section.m_type == section_type::read_only_data)
+			{
+				read_only.push_back(section);
+			}
+		}
+
+		std::vector<uint32_t> locators;
+		for (const auto& section : read_only)
+		{
+			const auto end = section.m_rva + section.m_size;
+			for (auto rva = (section.m_rva + 3) & ~3u; rva + sizeof(complete_object_locator) <= end; rva += 4)
+			{
+				const auto locator = read<complete_object_locator>(image, rva);
+				if (locator.m_signature == 1 && locator.m_self_rva == rva && is_type_descriptor(image, image_size, locator.m_type_descriptor_rva))
+				{
+					locators.push_back(rva);
+				}
+			}
+		}
+		std::ranges::sort(locators);
+
+		for (const auto& section : read_only)
+		{
+			const auto end = section.m_rva + section.m_size;
+			for (auto rva = (section.m_rva + 7) & ~7u; rva + 16 <= end; rva += 8)
+			{
+				const auto pointer = read<uint64_t>(image, rva);
+				if (pointer < image_base || pointer - image_base >= image_size)
+				{
+					continue;
+				}
+
+				const auto locator_rva = static_cast<uint32_t>(pointer - image_base);
+				if (!std::ranges::binary_search(locators, locator_rva))
+				{
+					continue;
+				}
+
+				const auto locator = read<complete_object_locator>(image, locator_rva);
+				m_vtables.push_back({rva + 8, locator.m_type_descriptor_rva, locator.m_offset});
+			}
+		}
+
+		std::ranges::sort(m_vtables,
+		                  [this](const rtti_vtable& a, const rtti_vtable& b)
+		                  {
+			                  return less(a, b);
+		                  });
+	}
+
+	rtti_index::rtti_index(const uint8_t* image, std::vector<rtti_vtable> vtables) :
+	    m_image(image),
+	    m_vtables(std::move(vtables))
+	{
+	}
+
+	bool rtti_index::is_valid(const uint8_t* image, std::size_t image_size, uint64_t image_base, std::span<const rtti_vtable> vtables)
+	{
+		for (const auto& vtable : vtables)
+		{
+			// The slot right before the vtable must still point to a locator describing the same class and offset.
+			if (vtable.m_vtable_rva < sizeof(uint64_t) || static_cast<std::size_t>(vtable.m_vtable_rva) + sizeof(uint64_t) > image_size)
+			{
+				return false;
+			}
+
+			const auto pointer = read<uint64_t>(image, vtable.m_vtable_rva - sizeof(uint64_t));
+			if (pointer < image_base || pointer - image_base + sizeof(complete_object_locator) > image_size)
+			{
+				return false;
+			}
+
+			const auto locator_rva = static_cast<uint32_t>(pointer - image_base);
+			const auto locator     = read<complete_object_locator>(image, locator_rva);
+			if (locator.m_signature != 1 || locator.m_self_rva != locator_rva || locator.m_type_descriptor_rva != vtable.m_type_descriptor_rva
+			    || locator.m_offset != vtable.m_offset || !is_type_descriptor(image, image_size, vtable.m_type_descriptor_rva))
+			{
+				return false;
+			}
+		}
+
+		const rtti_index index(image, {});
+		return std::ranges::is_sorted(vtables,
+		                              [&index](const rtti_vtable& a, const rtti_vtable& b)
+		                              {
+			                              return index.less(a, b);
+		                              });
+	}
+
+	bool rtti_index::less(const rtti_vtable& a, const rtti_vtable& b) const
+	{
+		const auto a_name = mangled_name(a);
+		const auto b_name = mangled_name(b);
+		if (a_name != b_name)
+		{
+			return a_name < b_name;
+		}
+
+		return a.m_offset != b.m_offset ? a.m_offset < b.m_offset : a.m_vtable_rva < b.m_vtable_rva;
+	}
+
+	std::optional<handle> rtti_index::find_vtable(std::string_view name, uint32_t offset) const
+	{
+		const auto mangled = mangle_type_name(name);
+
+		const auto [first, last] = std::ranges::equal_range(m_vtables,
+		                                                    std::string_view(mangled),
+		                                                    std::less{},
+		                                                    [this](const rtti_vtable& vtable)
+		                                                    {
+			                                                    return mangled_name(vtable);
+		                                                    });
+
+		const auto it = std::ranges::find(first, last, offset, &rtti_vtable::m_offset);
+		if (it == last)
+		{
+			return std::nullopt;
+		}
+
+		return handle(const_cast<uint8_t*>(m_image + it->m_vtable_rva));
+	}
+
+	std::string_view rtti_index::mangled_name(const rtti_vtable& vtable) const
+	{
+		return reinterpret_cast<const char*>(m_image + vtable.m_type_descriptor_rva + type_descriptor_name_offset);
+	}
+
+	std::string rtti_index::mangle_type_name(std::string_view name)
+	{
+		if (name.starts_with(".?A") || name.find('<') != std::string_view::npos)
+		{
+			return std::string(name);
+		}
+
+		// typeid(T).name() style, a bare name is taken as a class.
+		auto kind = 'V';
+		for (const auto& [prefix, code] : {std::pair{std::string_view("class "), 'V'}, {"struct ", 'U'}, {"union ", 'T'}})
+		{
+			if (name.starts_with(prefix))
+			{
+				name.remove_prefix(prefix.size());
+				kind = code;
+				break;
+			}
+		}
+
+		// Scopes are written innermost first: ns::Foo is Foo@ns@@.
+		std::vector<std::string_view> scopes;
+		for (const auto scope : std::views::split(name, std::string_view("::")))
+		{
+			scopes.emplace_back(scope.begin(), scope.end());
+		}
+
+		std::string mangled = ".?A";
+		mangled += kind;
+		for (const auto scope : scopes | std::views::reverse)
+		{
+			mangled += scope;
+			mangled += '@';
+		}
+		mangled += '@';
+		return mangled;
+	}
+
+	const std::vector<rtti_vtable>& rtti_index::vtables() const
+	{
+		return m_vtables;
+	}
+} // namespace memory
@@ -0,0 +1,76 @@
+#pragma once
+#include "handle.hpp"
+#include "pe.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <span>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace memory
+{
+	struct rtti_vtable
+	{
+		// First virtual function slot, the complete object locator pointer sits right before it.
+		uint32_t m_vtable_rva;
+		uint32_t m_type_descriptor_rva;
+		// Offset of this vtable in the complete object, 0 for the primary one.
+		uint32_t m_offset;
+	};
+
+	/**
+	 * @brief vtables of the polymorphic classes of an MSVC x64 image, looked up by class name.
+	 *
+	 * A single pass over the read-only data sections finds the RTTI complete object locators (signature 1, self rva pointing back at
+	 * them), then the vtables are the slots right after a pointer to one of those locators.
+	 * Lookups are a binary search on the mangled type name stored in the type descriptor.
+	 */
+	class rtti_index
+	{
+	public:
+		/**
+		 * @param image Start of the image laid out at its rvas, a loaded module or a pe_image.
+		 * @param image_base Address the absolute pointers of the image are relative to: the module base once loaded, the preferred base of a pe_image.
+		 * @param sections Clamped to the image, as returned by pe::read_sections.
+		 */
+		rtti_index(const uint8_t* image, std::size_t image_size, uint64_t image_base, const std::vector<pe::section_info>& sections);
+
+		/**
+		 * @brief Index restored from a previous build of the same image, vtables must already be sorted and pass is_valid.
+		 */
+		rtti_index(const uint8_t* image, std::vector<rtti_vtable> vtables);
+
+		/**
+		 * @brief Checks vtables coming from outside, such as a cache file, against the image before restoring an index from them:
+		 * every rva is inside the image, each vtable is still preceded by a locator of the same class and offset, and the order is the index one.
+		 */
+		static bool is_valid(const uint8_t* image, std::size_t image_size, uint64_t image_base, std::span<const rtti_vtable> vtables);
+
+		/**
+		 * @param name "class Foo", "struct ns::Bar" or the mangled type name (".?AVFoo@@"), which is the only way to find templates.
+		 * @param offset Offset of the wanted vtable in the object, for the secondary vtables of multiple inheritance.
+		 */
+		std::optional<handle> find_vtable(std::string_view name, uint32_t offset = 0) const;
+
+		// Mangled name of the class of the vtable, ".?AVFoo@@".
+		std::string_view mangled_name(const rtti_vtable& vtable) const;
+
+		/**
+		 * @brief "class ns::Foo" to ".?AVFoo@ns@@". Template names are returned unchanged, as are names which are already mangled.
+		 */
+		static std::string mangle_type_name(std::string_view name);
+
+		const std::vector<rtti_vtable>& vtables() const;
+
+	private:
+		// Index order: mangled name, then offset, then vtable rva.
+		bool less(const rtti_vtable& a, const rtti_vtable& b) const;
+
+		const uint8_t* m_image;
+		// Sorted by mangled name then offset.
+		std::vector<rtti_vtable> m_vtables;
+	};
+} // namespace memory
@@ -0,0 +1,56 @@
+#include "rtti_index_cache.hpp"
+
+namespace memory
+{
+	// Bump when the locator matching rules or the rtti_vtable layout change.
+	static constexpr uint64_t rtti_cache_version = 1;
+
+	void rtti_index_cache::set_folder(const std::filesystem::path& folder)
+	{
+		std::scoped_lock lock(m_lock);
+		m_folder = folder;
+	}
+
+	std::shared_ptr<const rtti_index> rtti_index_cache::load_or_build(const module& mod, const std::filesystem::path& folder)
+	{
+		const auto image = mod.begin().as<const uint8_t*>();
+		const auto base  = mod.begin().as<uintptr_t>();
+
+		// A truncated or edited file would make the index read outside of the image, it gets rebuilt instead.
+		module_cache_file<rtti_vtable> cache_file(folder, mod.name(), module_file_version(mod.timestamp(), mod.size()), "rtti", rtti_cache_version);
+		if (auto vtables = cache_file.load(); vtables && rtti_index::is_valid(image, mod.size(), base, *vtables))
+		{
+			return std::make_shared<const rtti_index>(image, std::move(*vtables));
+		}
+
+		// Pointers of the loaded module are already relocated, so relative to its actual base.
+		auto index = std::make_shared<const rtti_index>(image, mod.size(), base, pe::read_sections(image, mod.size()));
+		cache_file.write(index->vtables());
+		return index;
+	}
+
+	std::shared_ptr<const rtti_index> rtti_index_cache::get(const module& mod)
+	{
+		std::filesystem::path folder;
+		{
+			std::scoped_lock lock(m_lock);
+			if (const auto& index = m_indices.get(mod))
+			{
+				return index;
+			}
+
+			folder = m_folder;
+		}
+
+		auto index = load_or_build(mod, folder);
+
+		std::scoped_lock lock(m_lock);
+		m_indices.get(mod) = index;
+		return index;
+	}
+
+	std::optional<handle> rtti_index_cache::find_vtable(const module& mod, std::string_view name, uint32_t offset)
+	{
+		return get(mod)->find_vtable(name, offset);
+	}
+} // namespace memory
@@ -0,0 +1,46 @@
+#pragma once
+#include "handle.hpp"
+#include "module.hpp"
+#include "module_cache.hpp"
+#include "rtti_index.hpp"
+
+#include <filesystem>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <string_view>
+
+namespace memory
+{
+	/**
+	 * @brief RTTI indices of loaded modules, built once per module build and persisted next to the pattern cache.
+	 */
+	class rtti_index_cache
+	{
+	public:
+		/**
+		 * @brief Folder holding the cache files. Indices are only kept in memory until this is set.
+		 */
+		void set_folder(const std::filesystem::path& folder);
+
+		/**
+		 * @brief Index of the module, loaded from its cache file when it was written for the same build, built otherwise.
+		 */
+		std::shared_ptr<const rtti_index> get(const module& mod);
+
+		/**
+		 * @brief See rtti_index::find_vtable, builds the index of the module on first use.
+		 */
+		std::optional<handle> find_vtable(const module& mod, std::string_view name, uint32_t offset = 0);
+
+	private:
+		std::shared_ptr<const rtti_index> load_or_build(const module& mod, const std::filesystem::path& folder);
+
+		std::mutex m_lock;
+		std::filesystem::path m_folder;
+		module_entries<std::shared_ptr<const rtti_index>> m_indices;
+	};
+
+	inline auto g_rtti_index_cache = rtti_index_cache();
+} // namespace memory
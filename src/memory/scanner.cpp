@@ -0,0 +1,266 @@
+#include "scanner.hpp"
+
+#include <cstring>
+
+#if defined(_M_X64) || defined(_M_IX86) || defined(__x86_64__) || defined(__i386__)
+	#define MEMORY_SCANNER_X86 1
+	#include <immintrin.h>
+	#if defined(_MSC_VER)
+		#include <intrin.h>
+	#endif
+#endif
+
+#if defined(MEMORY_SCANNER_X86) && !defined(_MSC_VER)
+	// gcc / clang only let us use the intrinsics inside functions compiled for that target.
+	#define MEMORY_SCANNER_TARGET_AVX2 __attribute__((target("avx2")))
+#else
+	#define MEMORY_SCANNER_TARGET_AVX2
+#endif
+
+namespace memory::scanner
+{
+	static inline unsigned count_trailing_zeros(uint32_t mask)
+	{
+#if defined(_MSC_VER)
+		unsigned long index;
+		_BitScanForward(&index, mask);
+		return index;
+#else
+		return __builtin_ctz(mask);
+#endif
+	}
+
+	// The kernels call on_match with the offset of every match in increasing order, until it returns false.
+
+	template<typename F>
+	static void for_each_match_scalar(const uint8_t* data, std::size_t size, const pattern_view& sig, F&& on_match)
+	{
+		const auto candidate_count = size - sig.m_size + 1;
+
+		if (!sig.m_has_anchor)
+		{
+			for (std::size_t i = 0; i < candidate_count; ++i)
+			{
+				if (!on_match(i))
+				{
+					return;
+				}
+			}
+			return;
+		}
+
+		const auto first  = sig.m_values[sig.m_anchor];
+		const auto second = sig.m_values[sig.m_anchor2];
+
+		// memchr on the rarest byte is already vectorized by the CRT.
+		std::size_t i = 0;
+		while (i < candidate_count)
+		{
+			const auto found = static_cast<const uint8_t*>(memchr(data + sig.m_anchor + i, first, candidate_count - i));
+			if (!found)
+			{
+				break;
+			}
+
+			i = static_cast<std::size_t>(found - data) - sig.m_anchor;
+			if (data[i + sig.m_anchor2] == second && matches(data + i, sig) && !on_match(i))
+			{
+				return;
+			}
+
+			++i;
+		}
+	}
+
+#if defined(MEMORY_SCANNER_X86)
+	template<typename F>
+	static void for_each_match_sse2(const uint8_t* data, std::size_t size, const pattern_view& sig, F&& on_match)
+	{
+		if (!sig.m_has_anchor)
+		{
+			return for_each_match_scalar(data, size, sig, on_match);
+		}
+
+		const auto candidate_count = size - sig.m_size + 1;
+
+		const auto first  = _mm_set1_epi8(static_cast<char>(sig.m_values[sig.m_anchor]));
+		const auto second = _mm_set1_epi8(static_cast<char>(sig.m_values[sig.m_anchor2]));
+
+		const auto first_block  = data + sig.m_anchor;
+		const auto second_block = data + sig.m_anchor2;
+
+		std::size_t i = 0;
+		for (; i + 16 <= candidate_count; i += 16)
+		{
+			const auto eq_first  = _mm_cmpeq_epi8(first, _mm_loadu_si128(reinterpret_cast<const __m128i*>(first_block + i)));
+			const auto eq_second = _mm_cmpeq_epi8(second, _mm_loadu_si128(reinterpret_cast<const __m128i*>(second_block + i)));
+
+			auto mask = static_cast<uint32_t>(_mm_movemask_epi8(_mm_and_si128(eq_first, eq_second)));
+			while (mask)
+			{
+				const auto bit = count_trailing_zeros(mask);
+				if (matches(data + i + bit, sig) && !on_match(i + bit))
+				{
+					return;
+				}
+
+				mask &= mask - 1;
+			}
+		}
+
+		for (; i < candidate_count; ++i)
+		{
+			if (matches(data + i, sig) && !on_match(i))
+			{
+				return;
+			}
+		}
+	}
+
+	template<typename F>
+	MEMORY_SCANNER_TARGET_AVX2 static void for_each_match_avx2(const uint8_t* data, std::size_t size, const pattern_view& sig, F&& on_match)
+	{
+		if (!sig.m_has_anchor)
+		{
+			return for_each_match_scalar(data, size, sig, on_match);
+		}
+
+		const auto candidate_count = size - sig.m_size + 1;
+
+		const auto first  = _mm256_set1_epi8(static_cast<char>(sig.m_values[sig.m_anchor]));
+		const auto second = _mm256_set1_epi8(static_cast<char>(sig.m_values[sig.m_anchor2]));
+
+		const auto first_block  = data + sig.m_anchor;
+		const auto second_block = data + sig.m_anchor2;
+
+		std::size_t i = 0;
+		for (; i + 32 <= candidate_count; i += 32)
+		{
+			const auto eq_first  = _mm256_cmpeq_epi8(first, _mm256_loadu_si256(reinterpret_cast<const __m256i*>(first_block + i)));
+			const auto eq_second = _mm256_cmpeq_epi8(second, _mm256_loadu_si256(reinterpret_cast<const __m256i*>(second_block + i)));
+
+			auto mask = static_cast<uint32_t>(_mm256_movemask_epi8(_mm256_and_si256(eq_first, eq_second)));
+			while (mask)
+			{
+				const auto bit = count_trailing_zeros(mask);
+				if (matches(data + i + bit, sig) && !on_match(i + bit))
+				{
+					return;
+				}
+
+				mask &= mask - 1;
+			}
+		}
+
+		for (; i < candidate_count; ++i)
+		{
+			if (matches(data + i, sig) && !on_match(i))
+			{
+				return;
+			}
+		}
+	}
+
+	static bool cpu_has_avx2()
+	{
+#if defined(_MSC_VER)
+		int regs[4]{};
+		__cpuid(regs, 0);
+		if (regs[0] < 7)
+		{
+			return false;
+		}
+
+		__cpuid(regs, 1);
+		const auto has_osxsave = (regs[2] & (1 << 27)) != 0;
+		const auto has_avx     = (regs[2] & (1 << 28)) != 0;
+		if (!has_osxsave || !has_avx)
+		{
+			return false;
+		}
+
+		// The OS must save the YMM registers on context switches.
+		if ((_xgetbv(0) & 0x6) != 0x6)
+		{
+			return false;
+		}
+
+		__cpuidex(regs, 7, 0);
+		return (regs[1] & (1 << 5)) != 0;
+#else
+		return __builtin_cpu_supports("avx2");
+#endif
+	}
+#endif
+
+	isa best_isa()
+	{
+#if defined(MEMORY_SCANNER_X86)
+		static const isa s_best_isa = cpu_has_avx2() ? isa::avx2 : isa::sse2;
+		return s_best_isa;
+#else
+		return isa::scalar;
+#endif
+	}
+
+	template<typename F>
+	static void for_each_match(const uint8_t* data, std::size_t size, const pattern_view& sig, isa kernel, F&& on_match)
+	{
+		if (!data || !sig.m_size || size < sig.m_size)
+		{
+			return;
+		}
+
+		if (kernel > best_isa())
+		{
+			kernel = isa::scalar;
+		}
+
+		switch (kernel)
+		{
+#if defined(MEMORY_SCANNER_X86)
+		case isa::avx2: return for_each_match_avx2(data, size, sig, on_match);
+		case isa::sse2: return for_each_match_sse2(data, size, sig, on_match);
+#endif
+		default:        return for_each_match_scalar(data, size, sig, on_match);
+		}
+	}
+
+	std::size_t find_first(const uint8_t* data, std::size_t size, const pattern_view& sig, isa kernel)
+	{
+		auto result = npos;
+		for_each_match(data,
+		               size,
+		               sig,
+		               kernel,
+		               [&result](std::size_t offset)
+		               {
+			               result = offset;
+			               return false;
+		               });
+		return result;
+	}
+
+	std::size_t find_first(const uint8_t* data, std::size_t size, const pattern_view& sig)
+	{
+		return find_first(data, size, sig, best_isa());
+	}
+
+	void find_all(const uint8_t* data, std::size_t size, const pattern_view& sig, std::vector<std::size_t>& out, isa kernel)
+	{
+		for_each_match(data,
+		               size,
+		               sig,
+		               kernel,
+		               [&out](std::size_t offset)
+		               {
+			               out.push_back(offset);
+			               return true;
+		               });
+	}
+
+	void find_all(const uint8_t* data, std::size_t size, const pattern_view& sig, std::vector<std::size_t>& out)
+	{
+		find_all(data, size, sig, out, best_isa());
+	}
+} // namespace memory::scanner
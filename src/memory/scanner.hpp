@@ -0,0 +1,215 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace memory::scanner
+{
+	inline constexpr std::size_t npos = static_cast<std::size_t>(-1);
+
+	/**
+	 * @brief Dense byte + mask view of a pattern, this is what the scanning kernels consume.
+	 * A wildcard is stored as a zero value with a zero mask, so a byte matches when (byte & mask) == value.
+	 */
+	struct pattern_view
+	{
+		const uint8_t* m_values;
+		const uint8_t* m_masks;
+		std::size_t m_size;
+
+		// Offsets of the two rarest non-wildcard bytes, used by the prefilter.
+		// Both are equal when the pattern only has a single non-wildcard byte.
+		std::size_t m_anchor;
+		std::size_t m_anchor2;
+
+		// False when the pattern is only made of wildcards.
+		bool m_has_anchor;
+	};
+
+	enum class isa : uint8_t
+	{
+		scalar,
+		sse2,
+		avx2,
+	};
+
+	/**
+	 * @brief Best instruction set supported by the current CPU, computed once.
+	 */
+	isa best_isa();
+
+	/**
+	 * @brief Rough commonness of a byte value inside x86-64 code, higher is more common.
+	 * Only needs to be good enough to avoid picking 00 / FF / 48 / 8B style bytes as the prefilter.
+	 */
+	constexpr uint8_t byte_commonness(const uint8_t b)
+	{
+		switch (b)
+		{
+		case 0x00: return 255;
+		case 0x48: return 240;
+		case 0xFF: return 230;
+		case 0x8B: return 225;
+		case 0xCC: return 210;
+		case 0x89: return 200;
+		case 0x24: return 190;
+		case 0x0F: return 185;
+		case 0x4C: return 180;
+		case 0x8D: return 175;
+		case 0xE8: return 170;
+		case 0x44: return 165;
+		case 0x83: return 160;
+		case 0x01: return 150;
+		case 0xC0: return 145;
+		case 0x85: return 140;
+		case 0x49: return 135;
+		case 0x74: return 130;
+		case 0x20: return 130;
+		case 0x10: return 125;
+		case 0x08: return 125;
+		case 0x41: return 120;
+		case 0x75: return 120;
+		case 0x45: return 115;
+		case 0xC3: return 110;
+		case 0x40: return 110;
+		case 0x90: return 105;
+		case 0x28: return 100;
+		case 0x30: return 100;
+		case 0x18: return 100;
+		case 0x38: return 95;
+		case 0x33: return 95;
+		case 0x02: return 90;
+		case 0x04: return 90;
+		case 0xC7: return 90;
+		case 0xEB: return 85;
+		case 0xE9: return 85;
+		case 0x5C: return 80;
+		case 0x50: return 80;
+		case 0x80: return 80;
+		case 0x03: return 75;
+		case 0x54: return 75;
+		case 0x84: return 70;
+		case 0xC1: return 70;
+		case 0xF8: return 65;
+		case 0x3B: return 65;
+		case 0x39: return 65;
+		case 0x5F: return 60;
+		case 0x5B: return 60;
+		case 0x57: return 60;
+		case 0x53: return 60;
+		case 0x8E: return 55;
+		case 0x05: return 55;
+		case 0x0D: return 55;
+		case 0x15: return 55;
+		case 0xF0: return 50;
+		case 0x7F: return 50;
+		case 0x70: return 45;
+		default:   return 20;
+		}
+	}
+
+	/**
+	 * @brief Picks the two rarest non-wildcard bytes of a pattern, based on x86-64 code byte frequencies.
+	 * constexpr so that compile time patterns get their anchors for free.
+	 *
+	 * @return false if the pattern only contains wildcards.
+	 */
+	constexpr bool pick_anchors(const uint8_t* values, const uint8_t* masks, std::size_t size, std::size_t& anchor, std::size_t& anchor2)
+	{
+		constexpr auto no_anchor = npos;
+
+		anchor  = no_anchor;
+		anchor2 = no_anchor;
+
+		for (std::size_t i = 0; i < size; ++i)
+		{
+			if (masks[i] != 0xFF)
+			{
+				continue;
+			}
+
+			if (anchor == no_anchor || byte_commonness(values[i]) < byte_commonness(values[anchor]))
+			{
+				anchor = i;
+			}
+		}
+
+		if (anchor == no_anchor)
+		{
+			anchor  = 0;
+			anchor2 = 0;
+			return false;
+		}
+
+		// Second anchor must be a different byte value when possible, two identical bytes filter less.
+		for (std::size_t i = 0; i < size; ++i)
+		{
+			if (masks[i] != 0xFF || i == anchor)
+			{
+				continue;
+			}
+
+			if (anchor2 == no_anchor)
+			{
+				anchor2 = i;
+				continue;
+			}
+
+			const auto current_same   = values[anchor2] == values[anchor];
+			const auto candidate_same = values[i] == values[anchor];
+			if (current_same != candidate_same)
+			{
+				if (!candidate_same)
+				{
+					anchor2 = i;
+				}
+			}
+			else if (byte_commonness(values[i]) < byte_commonness(values[anchor2]))
+			{
+				anchor2 = i;
+			}
+		}
+
+		if (anchor2 == no_anchor)
+		{
+			anchor2 = anchor;
+		}
+
+		return true;
+	}
+
+	/**
+	 * @brief Checks the full pattern against the bytes at target, which must be readable for sig.m_size bytes.
+	 */
+	inline bool matches(const uint8_t* target, const pattern_view& sig)
+	{
+		for (std::size_t i = 0; i < sig.m_size; ++i)
+		{
+			if ((target[i] & sig.m_masks[i]) != sig.m_values[i])
+			{
+				return false;
+			}
+		}
+
+		return true;
+	}
+
+	/**
+	 * @brief Finds the first match of the pattern inside the [data, data + size) buffer.
+	 *
+	 * @return Offset of the match from data, npos otherwise.
+	 */
+	std::size_t find_first(const uint8_t* data, std::size_t size, const pattern_view& sig);
+
+	/**
+	 * @brief Same as above but forces the given kernel, mainly for benchmarking. Falls back to scalar if the CPU lacks it.
+	 */
+	std::size_t find_first(const uint8_t* data, std::size_t size, const pattern_view& sig, isa kernel);
+
+	/**
+	 * @brief Appends the offset of every match inside the [data, data + size) buffer to out, in increasing order.
+	 * out is not cleared, so callers can reuse its capacity between scans.
+	 */
+	void find_all(const uint8_t* data, std::size_t size, const pattern_view& sig, std::vector<std::size_t>& out);
+	void find_all(const uint8_t* data, std::size_t size, const pattern_view& sig, std::vector<std::size_t>& out, isa kernel);
+} // namespace memory::scanner
@@ -1,4 +1,6 @@
 #pragma once
+#include "handle.hpp"
+#include "static_pattern.hpp"
 
 namespace memory
 {
@@ -7,5 +9,17 @@ namespace memory
 		const char* m_name;
 		const char* m_ida;
 		void (*m_on_signature_found)(memory::handle ptr);
+		// m_ida compiled at build time by static_signature. Left empty, the batch scans parse m_ida at run time.
+		scanner::pattern_view m_pattern{};
 	};
+
+	/**
+	 * @brief Signature carrying the bytes, masks and anchors of its static_pattern, malformed patterns are compile errors.
+	 * Usage: memory::make_batch<memory::static_signature<"48 8B 05 ? ? ? ?">("name", on_found), ...>()
+	 */
+	template<fixed_string ida_sig>
+	constexpr signature static_signature(const char* name, void (*on_signature_found)(memory::handle ptr))
+	{
+		return {name, static_pattern<ida_sig>::text.m_data, on_signature_found, static_pattern<ida_sig>::view()};
+	}
 } // namespace memory
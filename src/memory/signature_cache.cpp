@@ -0,0 +1,113 @@
+#include "signature_cache.hpp"
+
+#include "module_cache.hpp"
+#include "scanner.hpp"
+
+namespace memory
+{
+	struct signature_cache_entry
+	{
+		uint32_t m_key;
+		uint32_t m_rva;
+	};
+
+	signature_cache::signature_cache(big::file cache_file, uint64_t cache_version) :
+	    m_cache_file(cache_file, cache_version)
+	{
+	}
+
+	bool signature_cache::load(uint32_t module_timestamp, size_t module_size)
+	{
+		m_file_version = module_file_version(module_timestamp, module_size);
+		m_key_to_rva.clear();
+		m_dirty = false;
+
+		if (!m_cache_file.load() || !m_cache_file.up_to_date(m_file_version) || m_cache_file.data_size() % sizeof(signature_cache_entry))
+		{
+			m_cache_file.free_data();
+			return false;
+		}
+
+		const auto entries     = reinterpret_cast<const signature_cache_entry*>(m_cache_file.data());
+		const auto entry_count = m_cache_file.data_size() / sizeof(signature_cache_entry);
+		for (size_t i = 0; i < entry_count; i++)
+		{
+			m_key_to_rva[entries[i].m_key] = entries[i].m_rva;
+		}
+
+		m_cache_file.free_data();
+		return true;
+	}
+
+	std::optional<handle> signature_cache::find(uint32_t key, const pattern& sig, const range& image) const
+	{
+		return find(key, sig.view(), image);
+	}
+
+	std::optional<handle> signature_cache::find(uint32_t key, const scanner::pattern_view& sig_view, const range& image) const
+	{
+		const auto it = m_key_to_rva.find(key);
+		if (it == m_key_to_rva.end())
+		{
+			return std::nullopt;
+		}
+
+		const auto rva = static_cast<size_t>(it->second);
+		if (!sig_view.m_size || rva + sig_view.m_size > image.size())
+		{
+			return std::nullopt;
+		}
+
+		const auto address = image.begin().add(rva);
+		if (!scanner::matches(address.as<const uint8_t*>(), sig_view))
+		{
+			return std::nullopt;
+		}
+
+		return address;
+	}
+
+	void signature_cache::insert(uint32_t key, handle address, const range& image)
+	{
+		if (!image.contains(address))
+		{
+			return;
+		}
+
+		const auto rva = static_cast<uint32_t>(address.as<uintptr_t>() - image.begin().as<uintptr_t>());
+
+		const auto it = m_key_to_rva.find(key);
+		if (it != m_key_to_rva.end() && it->second == rva)
+		{
+			return;
+		}
+
+		m_key_to_rva[key] = rva;
+		m_dirty           = true;
+	}
+
+	bool signature_cache::write()
+	{
+		if (!m_dirty)
+		{
+			return true;
+		}
+
+		const auto data_size = m_key_to_rva.size() * sizeof(signature_cache_entry);
+		auto data            = std::make_unique<uint8_t[]>(data_size);
+		auto entries         = reinterpret_cast<signature_cache_entry*>(data.get());
+		for (const auto& [key, rva] : m_key_to_rva)
+		{
+			*entries++ = {key, rva};
+		}
+
+		m_cache_file.set_data(std::move(data), data_size);
+		m_cache_file.set_header_version(m_file_version);
+
+		const auto written = m_cache_file.write();
+		m_cache_file.free_data();
+
+		m_dirty = !written;
+		return written;
+	}
+} // namespace memory
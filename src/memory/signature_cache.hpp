@@ -0,0 +1,54 @@
+#pragma once
+#include "file_manager/cache_file.hpp"
+#include "handle.hpp"
+#include "pattern.hpp"
+#include "range.hpp"
+
+#include <ankerl/unordered_dense.h>
+#include <optional>
+
+namespace memory
+{
+	/**
+	 * @brief Persistent map of signature keys to module relative addresses.
+	 *
+	 * The cache is only considered valid for the exact module build it was written for (PE timestamp + image size),
+	 * and every cached address is validated against its pattern before being returned.
+	 */
+	class signature_cache
+	{
+	public:
+		/**
+		 * @param cache_file File backing the cache.
+		 * @param cache_version Invalidates the cache when it changes, for example a hash of the batch signatures.
+		 */
+		signature_cache(big::file cache_file, uint64_t cache_version);
+
+		/**
+		 * @brief Loads the cache from disk, discarding it if it was written for another module build.
+		 *
+		 * @return true if there was an up to date cache on disk.
+		 */
+		bool load(uint32_t module_timestamp, size_t module_size);
+
+		/**
+		 * @brief Returns the cached address for the key, only if the pattern still matches there.
+		 */
+		std::optional<handle> find(uint32_t key, const pattern& sig, const range& image) const;
+		std::optional<handle> find(uint32_t key, const scanner::pattern_view& sig, const range& image) const;
+
+		void insert(uint32_t key, handle address, const range& image);
+
+		/**
+		 * @brief Writes the cache to disk if it changed since it was loaded.
+		 */
+		bool write();
+
+	private:
+		big::cache_file m_cache_file;
+		uint64_t m_file_version{};
+
+		ankerl::unordered_dense::map<uint32_t, uint32_t> m_key_to_rva;
+		bool m_dirty{};
+	};
+} // namespace memory
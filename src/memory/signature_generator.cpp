@@ -0,0 +1,220 @@
+#include "signature_generator.hpp"
+
+#include "length_decoder.hpp"
+#include "pattern.hpp"
+
+#include <algorithm>
+#include <vector>
+
+namespace memory
+{
+	// Below this, the first scan returns far too many candidates to be worth it.
+	static constexpr std::size_t min_solid_bytes = 5;
+
+	static std::string to_ida(const std::vector<std::optional<uint8_t>>& bytes, std::size_t length)
+	{
+		static constexpr char hex_digits[] = "0123456789ABCDEF";
+
+		std::string ida;
+		ida.reserve(length * 3);
+		for (std::size_t i = 0; i < length; i++)
+		{
+			if (i)
+			{
+				ida += ' ';
+			}
+
+			if (bytes[i])
+			{
+				ida += hex_digits[*bytes[i] >> 4];
+				ida += hex_digits[*bytes[i] & 0x0F];
+			}
+			else
+			{
+				ida += '?';
+			}
+		}
+
+		return ida;
+	}
+
+	// Whether the candidate, already matching the signature before from, also matches its bytes in [from, to).
+	static bool matches_bytes(const std::vector<range>& scanned_ranges, handle candidate, const std::vector<std::optional<uint8_t>>& bytes, std::size_t from, std::size_t to)
+	{
+		const auto owner = std::ranges::find_if(scanned_ranges,
+		                                        [candidate](const range& scanned_range)
+		                                        {
+			                                        return scanned_range.contains(candidate);
+		                                        });
+		if (owner == scanned_ranges.end() || candidate.as<uintptr_t>() + to > owner->end().as<uintptr_t>())
+		{
+			return false;
+		}
+
+		const auto target = candidate.as<const uint8_t*>();
+		for (auto i = from; i < to; i++)
+		{
+			if (bytes[i] && target[i] != *bytes[i])
+			{
+				return false;
+			}
+		}
+
+		return true;
+	}
+
+	std::optional<std::string> make_signature(const range& image, handle address, const signature_options& options)
+	{
+		const auto data = image.begin().as<const uint8_t*>();
+		if (!image.contains(address))
+		{
+			return std::nullopt;
+		}
+
+		const auto rva = static_cast<uint32_t>(address.as<uintptr_t>() - image.begin().as<uintptr_t>());
+
+		std::vector<range> scanned_ranges;
+		std::optional<range> own_range;
+		for (const auto& section : pe::read_sections(data, image.size()))
+		{
+			if (!has_section_type(options.m_sections, section.m_type))
+			{
+				continue;
+			}
+
+			scanned_ranges.emplace_back(image.begin().add(section.m_rva), section.m_size);
+			if (rva >= section.m_rva && rva < section.m_rva + section.m_size)
+			{
+				own_range = scanned_ranges.back();
+			}
+		}
+
+		if (!own_range)
+		{
+			return std::nullopt;
+		}
+
+		const auto available = std::min<std::size_t>(options.m_max_length, own_range->end().as<uintptr_t>() - address.as<uintptr_t>());
+
+		// A relocated 8 byte address can start up to 7 bytes before the signature.
+		const auto relocations = pe::read_relocations(data, image.size(), rva >= 7 ? rva - 7 : 0, static_cast<uint32_t>(rva + available));
+
+		std::vector<std::optional<uint8_t>> bytes;
+		std::vector<handle> candidates;
+		std::vector<handle> previous_candidates;
+		bool scanned = false;
+
+		const auto code = address.as<const uint8_t*>();
+		while (bytes.size() < available)
+		{
+			const auto instruction = x64::decode_length(code + bytes.size(), available - bytes.size());
+			if (!instruction)
+			{
+				return std::nullopt;
+			}
+
+			const auto begin = bytes.size();
+			for (std::size_t i = 0; i < instruction->m_length; i++)
+			{
+				bytes.emplace_back(code[begin + i]);
+			}
+
+			const auto wildcard = [&](std::size_t offset, std::size_t size)
+			{
+				for (std::size_t i = 0; i < size; i++)
+				{
+					bytes[begin + offset + i].reset();
+				}
+			};
+
+			if (instruction->m_rip_relative)
+			{
+				wildcard(instruction->m_displacement_offset, instruction->m_displacement_size);
+			}
+			if (instruction->m_relative_immediate && instruction->m_immediate_size == 4)
+			{
+				wildcard(instruction->m_immediate_offset, instruction->m_immediate_size);
+			}
+			for (const auto relocation : relocations)
+			{
+				for (uint32_t i = relocation; i < relocation + 8; i++)
+				{
+					if (i >= rva + begin && i < rva + bytes.size())
+					{
+						bytes[i - rva].reset();
+					}
+				}
+			}
+
+			const auto solid_bytes = std::ranges::count_if(bytes,
+			                                               [](const std::optional<uint8_t>& byte)
+			                                               {
+				                                               return byte.has_value();
+			                                               });
+
+			if (!scanned)
+			{
+				if (static_cast<std::size_t>(solid_bytes) < min_solid_bytes && bytes.size() < available)
+				{
+					continue;
+				}
+
+				const pattern sig(to_ida(bytes, bytes.size()));
+				std::vector<handle> matches;
+				for (const auto& scanned_range : scanned_ranges)
+				{
+					scanned_range.scan_all(sig, matches);
+					candidates.insert(candidates.end(), matches.begin(), matches.end());
+				}
+
+				scanned = true;
+			}
+			else
+			{
+				// Already matched the shorter signature, only the new bytes need checking.
+				previous_candidates = std::move(candidates);
+				candidates.clear();
+				for (const auto candidate : previous_candidates)
+				{
+					if (matches_bytes(scanned_ranges, candidate, bytes, begin, bytes.size()))
+					{
+						candidates.push_back(candidate);
+					}
+				}
+			}
+
+			if (candidates.size() == 1 && candidates.front() == address)
+			{
+				// Cut the signature right after the byte that made it unique, when the candidates before this instruction are known.
+				auto length = previous_candidates.empty() ? bytes.size() : begin + 1;
+				for (; length < bytes.size(); length++)
+				{
+					const auto other_matches = std::ranges::count_if(previous_candidates,
+					                                                 [&](handle candidate)
+					                                                 {
+						                                                 return candidate != address && matches_bytes(scanned_ranges, candidate, bytes, begin, length);
+					                                                 });
+					if (!other_matches)
+					{
+						break;
+					}
+				}
+
+				while (!bytes[length - 1])
+				{
+					length--;
+				}
+
+				return to_ida(bytes, length);
+			}
+
+			if (candidates.empty())
+			{
+				// The code at the address changed while we were reading it.
+				return std::nullopt;
+			}
+		}
+
+		return std::nullopt;
+	}
+} // namespace memory
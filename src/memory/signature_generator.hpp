@@ -0,0 +1,31 @@
+#pragma once
+#include "handle.hpp"
+#include "pe.hpp"
+#include "range.hpp"
+
+#include <cstddef>
+#include <optional>
+#include <string>
+
+namespace memory
+{
+	struct signature_options
+	{
+		// Longest signature tried, in bytes.
+		std::size_t m_max_length = 64;
+		// The signature is unique among these sections of the image.
+		section_type m_sections = section_type::executable;
+	};
+
+	/**
+	 * @brief Builds the shortest IDA signature matching only at the address, among the chosen sections of the image.
+	 *
+	 * The signature grows one decoded instruction at a time. RIP-relative displacements, rel32 branch targets and relocated
+	 * addresses are wildcarded so that it survives code and data moving around in the next game build. Candidates are found with a single
+	 * parallel SIMD scan once the signature has a few solid bytes, then every longer signature only rechecks the remaining candidates.
+	 *
+	 * @param image A loaded module or any image laid out at its rvas, such as range(pe_image.base(), pe_image.size()).
+	 * @return nullopt if the address is not in the scanned sections, or no unique signature fits in m_max_length.
+	 */
+	std::optional<std::string> make_signature(const range& image, handle address, const signature_options& options = {});
+} // namespace memory
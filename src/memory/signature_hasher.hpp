@@ -0,0 +1,44 @@
+#pragma once
+#include "handle.hpp"
+#include "signature.hpp"
+#include "static_pattern.hpp"
+
+#include <cstdint>
+
+namespace memory
+{
+	struct signature_hasher
+	{
+		static inline constexpr uint32_t FNV_PRIME_32  = 16'777'619u;
+		static inline constexpr uint32_t FNV_OFFSET_32 = 2'166'136'261u;
+
+		static inline constexpr uint32_t fnv1a_32(const char* str, uint32_t hash = FNV_OFFSET_32) noexcept
+		{
+			return (str[0] == '\0') ? hash : fnv1a_32(&str[1], (hash ^ static_cast<uint32_t>(str[0])) * FNV_PRIME_32);
+		}
+
+		template<signature sig>
+		static inline constexpr uint32_t compute_hash(uint32_t hash)
+		{
+			// Fails to compile when the signature is malformed instead of silently never matching at runtime.
+			static_assert(ida::parse(sig.m_ida, nullptr, nullptr), "Malformed IDA signature.");
+
+			hash = fnv1a_32(sig.m_ida, hash);
+
+			return hash;
+		}
+
+		template<signature sig, signature... rest_sigs>
+		static inline constexpr uint32_t add(uint32_t hash = FNV_OFFSET_32)
+		{
+			hash = compute_hash<sig>(hash);
+
+			if constexpr (sizeof...(rest_sigs) > 0)
+			{
+				hash = add<rest_sigs...>(hash);
+			}
+
+			return hash;
+		}
+	};
+} // namespace memory
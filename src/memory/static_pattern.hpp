@@ -0,0 +1,161 @@
+#pragma once
+#include "scanner.hpp"
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <stdexcept>
+#include <string_view>
+
+namespace memory
+{
+	namespace ida
+	{
+		constexpr int hex_digit(const char c)
+		{
+			if (c >= '0' && c <= '9')
+			{
+				return c - '0';
+			}
+			if (c >= 'a' && c <= 'f')
+			{
+				return c - 'a' + 0xa;
+			}
+			if (c >= 'A' && c <= 'F')
+			{
+				return c - 'A' + 0xA;
+			}
+
+			return -1;
+		}
+
+		/**
+		 * @brief Strict parser for IDA style signatures ("48 8B 05 ? ?? ? ?"), every byte must be 2 hex digits or a wildcard.
+		 * Throws on malformed input, which turns into a compile error when evaluated at compile time.
+		 *
+		 * @param values Can be null to only count the bytes, same for masks.
+		 * @return Number of bytes of the signature.
+		 */
+		constexpr std::size_t parse(std::string_view sig, uint8_t* values, uint8_t* masks)
+		{
+			std::size_t size = 0;
+			for (std::size_t i = 0; i < sig.size();)
+			{
+				if (sig[i] == ' ')
+				{
+					++i;
+					continue;
+				}
+
+				auto token_end = i;
+				while (token_end < sig.size() && sig[token_end] != ' ')
+				{
+					++token_end;
+				}
+
+				const auto token = sig.substr(i, token_end - i);
+				uint8_t value    = 0;
+				uint8_t mask     = 0;
+				if (token != "?" && token != "??")
+				{
+					if (token.size() != 2 || hex_digit(token[0]) < 0 || hex_digit(token[1]) < 0)
+					{
+						throw std::invalid_argument("Malformed IDA signature, bytes must be 2 hex digits or ? / ??.");
+					}
+
+					value = static_cast<uint8_t>(hex_digit(token[0]) * 0x10 + hex_digit(token[1]));
+					mask  = 0xFF;
+				}
+
+				if (values)
+				{
+					values[size] = value;
+				}
+				if (masks)
+				{
+					masks[size] = mask;
+				}
+
+				++size;
+				i = token_end;
+			}
+
+			if (!size)
+			{
+				throw std::invalid_argument("Empty IDA signature.");
+			}
+
+			return size;
+		}
+	} // namespace ida
+
+	template<std::size_t N>
+	struct fixed_string
+	{
+		char m_data[N]{};
+
+		consteval fixed_string(const char (&str)[N])
+		{
+			for (std::size_t i = 0; i < N; ++i)
+			{
+				m_data[i] = str[i];
+			}
+		}
+
+		constexpr std::string_view view() const
+		{
+			return {m_data, N - 1};
+		}
+	};
+
+	/**
+	 * @brief Pattern parsed at compile time, the bytes, masks and prefilter anchors are baked into the binary.
+	 * Malformed signatures are compile errors. Usage: mod.scan(memory::static_pattern<"48 8B 05 ? ? ? ?">());
+	 */
+	template<fixed_string ida_sig>
+	class static_pattern
+	{
+	public:
+		static constexpr std::size_t size = ida::parse(ida_sig.view(), nullptr, nullptr);
+		// Copy of the signature text. Unlike the template parameter object, its address can be part of a template argument.
+		static constexpr fixed_string text = ida_sig;
+
+	private:
+		struct compiled_pattern
+		{
+			std::array<uint8_t, size> m_values{};
+			std::array<uint8_t, size> m_masks{};
+			std::size_t m_anchor{};
+			std::size_t m_anchor2{};
+			bool m_has_anchor{};
+		};
+
+		static consteval compiled_pattern compile()
+		{
+			compiled_pattern result{};
+			ida::parse(ida_sig.view(), result.m_values.data(), result.m_masks.data());
+			result.m_has_anchor = scanner::pick_anchors(result.m_values.data(), result.m_masks.data(), size, result.m_anchor, result.m_anchor2);
+			return result;
+		}
+
+		static constexpr compiled_pattern s_compiled = compile();
+
+	public:
+		static constexpr scanner::pattern_view view()
+		{
+			return {
+			    .m_values     = s_compiled.m_values.data(),
+			    .m_masks      = s_compiled.m_masks.data(),
+			    .m_size       = size,
+			    .m_anchor     = s_compiled.m_anchor,
+			    .m_anchor2    = s_compiled.m_anchor2,
+			    .m_has_anchor = s_compiled.m_has_anchor,
+			};
+		}
+
+		constexpr operator scanner::pattern_view() const
+		{
+			return view();
+		}
+	};
+} // namespace memory
@@ -0,0 +1,127 @@
+#include "string_index.hpp"
+
+#include <algorithm>
+
+namespace memory
+{
+	static constexpr bool is_printable(uint8_t c)
+	{
+		return (c >= 0x20 && c < 0x7F) || c == '\t' || c == '\n' || c == '\r';
+	}
+
+	// fnv1a over the characters, the same for a narrow string and its UTF-16 version.
+	static constexpr uint32_t hash_chars(const uint8_t* data, std::size_t length, std::size_t stride)
+	{
+		uint32_t hash = 0x81'1C'9D'C5;
+		for (std::size_t i = 0; i < length; i++)
+		{
+			hash = (hash ^ data[i * stride]) * 0x01'00'01'93;
+		}
+		return hash;
+	}
+
+	string_index::string_index(const uint8_t* image, const std::vector<pe::section_info>& sections) :
+	    m_image(image)
+	{
+		for (const auto& section : sections)
+		{
+			if (section.m_type == section_type::read_only_data)
+			{
+				index_narrow(section.m_rva, section.m_rva + section.m_size);
+				index_wide(section.m_rva, section.m_rva + section.m_size);
+			}
+		}
+
+		std::ranges::sort(m_entries,
+		                  [](const entry& a, const entry& b)
+		                  {
+			                  return a.m_hash != b.m_hash ? a.m_hash < b.m_hash : a.m_rva < b.m_rva;
+		                  });
+	}
+
+	void string_index::index_narrow(uint32_t begin, uint32_t end)
+	{
+		uint32_t run_begin = begin;
+		for (auto rva = begin; rva < end; rva++)
+		{
+			const auto c = m_image[rva];
+			if (is_printable(c))
+			{
+				continue;
+			}
+
+			const auto length = rva - run_begin;
+			if (c == 0 && length >= min_length)
+			{
+				m_entries.push_back({hash_chars(m_image + run_begin, length, 1), run_begin, length, false});
+			}
+
+			run_begin = rva + 1;
+		}
+	}
+
+	void string_index::index_wide(uint32_t begin, uint32_t end)
+	{
+		begin = (begin + 1) & ~1u;
+
+		uint32_t run_begin = begin;
+		for (auto rva = begin; rva + 1 < end; rva += 2)
+		{
+			const auto c = m_image[rva];
+			if (m_image[rva + 1] == 0 && is_printable(c))
+			{
+				continue;
+			}
+
+			const auto length = (rva - run_begin) / 2;
+			if (c == 0 && m_image[rva + 1] == 0 && length >= min_length)
+			{
+				m_entries.push_back({hash_chars(m_image + run_begin, length, 2), run_begin, length, true});
+			}
+
+			run_begin = rva + 2;
+		}
+	}
+
+	bool string_index::equals(const entry& entry, std::string_view str) const
+	{
+		if (entry.m_length != str.size())
+		{
+			return false;
+		}
+
+		const auto stride = entry.m_wide ? 2 : 1;
+		for (std::size_t i = 0; i < str.size(); i++)
+		{
+			if (m_image[entry.m_rva + i * stride] != static_cast<uint8_t>(str[i]))
+			{
+				return false;
+			}
+		}
+
+		return true;
+	}
+
+	std::vector<uint32_t> string_index::find(std::string_view str) const
+	{
+		std::vector<uint32_t> result;
+
+		const auto hash          = hash_chars(reinterpret_cast<const uint8_t*>(str.data()), str.size(), 1);
+		const auto [first, last] = std::ranges::equal_range(m_entries, hash, std::less{}, &entry::m_hash);
+		for (const auto& entry : std::ranges::subrange(first, last))
+		{
+			if (equals(entry, str))
+			{
+				result.push_back(entry.m_rva);
+			}
+		}
+
+		std::ranges::sort(result);
+		return result;
+	}
+
+	std::size_t string_index::size() const
+	{
+		return m_entries.size();
+	}
+} // namespace memory
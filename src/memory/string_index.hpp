@@ -0,0 +1,52 @@
+#pragma once
+#include "pe.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <string_view>
+#include <vector>
+
+namespace memory
+{
+	/**
+	 * @brief Locations of the string literals of an image, looked up by content.
+	 *
+	 * Indexes the NUL terminated runs of printable ASCII in the read-only data sections, both as narrow strings and as UTF-16
+	 * (2 byte aligned, ASCII range only) strings. Built in a single pass, lookups are a binary search on the content hash.
+	 */
+	class string_index
+	{
+	public:
+		// Shorter runs are mostly noise from non string data.
+		static constexpr std::size_t min_length = 4;
+
+		/**
+		 * @param image Start of the image laid out at its rvas, a loaded module or a pe_image.
+		 * @param sections Clamped to the image, as returned by pe::read_sections.
+		 */
+		string_index(const uint8_t* image, const std::vector<pe::section_info>& sections);
+
+		/**
+		 * @return rva of every literal whose content is exactly str, narrow and UTF-16 ones, sorted.
+		 */
+		std::vector<uint32_t> find(std::string_view str) const;
+
+		std::size_t size() const;
+
+	private:
+		struct entry
+		{
+			uint32_t m_hash;
+			uint32_t m_rva;
+			uint32_t m_length;
+			bool m_wide;
+		};
+
+		void index_narrow(uint32_t begin, uint32_t end);
+		void index_wide(uint32_t begin, uint32_t end);
+		bool equals(const entry& entry, std::string_view str) const;
+
+		const uint8_t* m_image;
+		std::vector<entry> m_entries;
+	};
+} // namespace memory
@@ -0,0 +1,544 @@
+#include "value_scanner.hpp"
+
+#include "threads/thread_pool.hpp"
+
+#include <algorithm>
+#include <bit>
+#include <cmath>
+#include <cstring>
+#include <type_traits>
+
+#if defined(_M_X64) || defined(_M_IX86) || defined(__x86_64__) || defined(__i386__)
+	#define MEMORY_VALUE_SCANNER_SSE2 1
+	#include <emmintrin.h>
+#endif
+
+namespace memory
+{
+	template<typename F>
+	static decltype(auto) visit_type(value_type type, F&& f)
+	{
+		switch (type)
+		{
+		case value_type::u8:  return f(uint8_t{});
+		case value_type::u16: return f(uint16_t{});
+		case value_type::u32: return f(uint32_t{});
+		case value_type::u64: return f(uint64_t{});
+		case value_type::i8:  return f(int8_t{});
+		case value_type::i16: return f(int16_t{});
+		case value_type::i32: return f(int32_t{});
+		case value_type::i64: return f(int64_t{});
+		case value_type::f32: return f(float{});
+		default:              return f(double{});
+		}
+	}
+
+	template<typename T>
+	static T to_value(const scan_value& value)
+	{
+		return std::visit(
+		    []<typename V>(V value) -> T
+		    {
+			    if constexpr (std::is_floating_point_v<T> || std::is_integral_v<V>)
+			    {
+				    // Integers wrap around like they would in the game memory.
+				    return static_cast<T>(value);
+			    }
+			    else if (std::isnan(value))
+			    {
+				    return 0;
+			    }
+			    else
+			    {
+				    // A double to integer conversion is only defined in range: saturate to 64 bits first, then wrap.
+				    return value < 0 ? static_cast<T>(static_cast<int64_t>(std::max(value, -9'223'372'036'854'775'808.0))) :
+				                       static_cast<T>(static_cast<uint64_t>(std::min(value, 18'446'744'073'709'549'568.0)));
+			    }
+		    },
+		    value);
+	}
+
+	template<typename T>
+	struct typed_condition
+	{
+		value_compare m_compare;
+		T m_value;
+		T m_max;
+		T m_tolerance;
+
+		explicit typed_condition(const value_condition& condition) :
+		    m_compare(condition.m_compare),
+		    m_value(to_value<T>(condition.m_value)),
+		    m_max(to_value<T>(condition.m_max)),
+		    m_tolerance(to_value<T>(condition.m_tolerance))
+		{
+		}
+
+		bool matches(T current, T previous) const
+		{
+			switch (m_compare)
+			{
+			case value_compare::exact:
+				if constexpr (std::is_floating_point_v<T>)
+				{
+					return std::abs(current - m_value) <= m_tolerance;
+				}
+				else
+				{
+					return current == m_value;
+				}
+			case value_compare::range:     return current >= m_value && current <= m_max;
+			case value_compare::changed:   return current != previous;
+			case value_compare::unchanged: return current == previous;
+			case value_compare::increased: return current > previous;
+			case value_compare::decreased: return current < previous;
+			default:                       return false;
+			}
+		}
+	};
+
+	template<typename T>
+	static T read_value(uintptr_t address)
+	{
+		T value;
+		std::memcpy(&value, reinterpret_cast<const void*>(address), sizeof(T));
+		return value;
+	}
+
+	static void write_leb128(std::vector<uint8_t>& out, uint64_t value)
+	{
+		do
+		{
+			auto byte = static_cast<uint8_t>(value & 0x7F);
+			value >>= 7;
+			if (value)
+			{
+				byte |= 0x80;
+			}
+			out.push_back(byte);
+		} while (value);
+	}
+
+	static uint64_t read_leb128(const uint8_t*& in)
+	{
+		uint64_t value = 0;
+		for (int shift = 0;; shift += 7)
+		{
+			const auto byte = *in++;
+			value |= static_cast<uint64_t>(byte & 0x7F) << shift;
+			if (!(byte & 0x80))
+			{
+				return value;
+			}
+		}
+	}
+
+	// Appends candidates to a value_scanner::candidate_block.
+	template<typename T, typename Block>
+	class block_writer
+	{
+	public:
+		block_writer(Block& block, std::size_t alignment) :
+		    m_block(block),
+		    m_alignment(alignment)
+		{
+		}
+
+		void add(uintptr_t address, T value)
+		{
+			if (!m_block.m_count)
+			{
+				m_block.m_base = address;
+				m_last         = address;
+			}
+
+			write_leb128(m_block.m_deltas, (address - m_last) / m_alignment);
+			m_last = address;
+
+			const auto offset = m_block.m_values.size();
+			m_block.m_values.resize(offset + sizeof(T));
+			std::memcpy(m_block.m_values.data() + offset, &value, sizeof(T));
+
+			m_block.m_count++;
+		}
+
+	private:
+		Block& m_block;
+		std::size_t m_alignment;
+		uintptr_t m_last{};
+	};
+
+	template<typename T, typename Writer>
+	static void first_scan_scalar(uintptr_t begin, uintptr_t end, std::size_t alignment, const typed_condition<T>& condition, Writer& writer)
+	{
+		for (auto address = begin; address + sizeof(T) <= end; address += alignment)
+		{
+			const auto value = read_value<T>(address);
+			if (condition.matches(value, value))
+			{
+				writer.add(address, value);
+			}
+		}
+	}
+
+#if defined(MEMORY_VALUE_SCANNER_SSE2)
+	// Exact integer search on naturally aligned values: byte compare 16 bytes at once against the repeated value,
+	// then keep the elements whose bytes all matched.
+	template<typename T, typename Writer>
+	static void first_scan_exact_sse2(uintptr_t begin, uintptr_t end, const typed_condition<T>& condition, Writer& writer)
+	{
+		uint8_t repeated[16];
+		for (std::size_t i = 0; i < sizeof(repeated); i += sizeof(T))
+		{
+			std::memcpy(repeated + i, &condition.m_value, sizeof(T));
+		}
+
+		const auto needle = _mm_loadu_si128(reinterpret_cast<const __m128i*>(repeated));
+
+		auto address = begin;
+		for (; address + 16 <= end; address += 16)
+		{
+			const auto block = _mm_loadu_si128(reinterpret_cast<const __m128i*>(address));
+			auto mask        = static_cast<uint32_t>(_mm_movemask_epi8(_mm_cmpeq_epi8(block, needle)));
+			if constexpr (sizeof(T) >= 2)
+			{
+				mask &= mask >> 1;
+			}
+			if constexpr (sizeof(T) >= 4)
+			{
+				mask &= mask >> 2;
+			}
+			if constexpr (sizeof(T) >= 8)
+			{
+				mask &= mask >> 4;
+			}
+			mask &= sizeof(T) == 1 ? 0xFF'FF : sizeof(T) == 2 ? 0x55'55 : sizeof(T) == 4 ? 0x11'11 : 0x01'01;
+
+			while (mask)
+			{
+				writer.add(address + std::countr_zero(mask), condition.m_value);
+				mask &= mask - 1;
+			}
+		}
+
+		first_scan_scalar(address, end, sizeof(T), condition, writer);
+	}
+#endif
+
+	template<typename T, typename Writer>
+	static void first_scan_chunk(uintptr_t begin, uintptr_t end, std::size_t alignment, const typed_condition<T>& condition, Writer& writer)
+	{
+#if defined(MEMORY_VALUE_SCANNER_SSE2)
+		if constexpr (std::is_integral_v<T>)
+		{
+			if (condition.m_compare == value_compare::exact && alignment == sizeof(T))
+			{
+				return first_scan_exact_sse2(begin, end, condition, writer);
+			}
+		}
+#endif
+
+		first_scan_scalar(begin, end, alignment, condition, writer);
+	}
+
+	// Region containing [address, address + size), nullptr if it is not readable anymore.
+	static const region* find_region(const std::vector<region>& regions, uintptr_t address, std::size_t size)
+	{
+		const auto it = std::ranges::upper_bound(regions, address, std::less{}, &region::m_base);
+		if (it == regions.begin())
+		{
+			return nullptr;
+		}
+
+		const auto& region = *(it - 1);
+		return address + size <= region.m_base + region.m_size ? &region : nullptr;
+	}
+
+	struct address_span
+	{
+		uintptr_t m_begin;
+		uintptr_t m_end;
+	};
+
+	// Sorted and merged, so only the last span starting before an address can contain it.
+	static void merge_spans(std::vector<address_span>& spans)
+	{
+		std::ranges::sort(spans, std::less{}, &address_span::m_begin);
+
+		std::vector<address_span> merged;
+		for (const auto& span : spans)
+		{
+			if (!merged.empty() && span.m_begin <= merged.back().m_end)
+			{
+				merged.back().m_end = std::max(merged.back().m_end, span.m_end);
+			}
+			else
+			{
+				merged.push_back(span);
+			}
+		}
+
+		spans = std::move(merged);
+	}
+
+	static bool overlaps(const std::vector<address_span>& spans, uintptr_t begin, uintptr_t end)
+	{
+		const auto it = std::ranges::upper_bound(spans, end - 1, std::less{}, &address_span::m_begin);
+		return it != spans.begin() && (it - 1)->m_end > begin;
+	}
+
+	// Copy of the block without the candidates overlapping the spans.
+	template<typename T, typename Block>
+	static Block without_spans(const Block& block, std::size_t alignment, const std::vector<address_span>& spans)
+	{
+		Block kept{};
+		block_writer<T, Block> writer(kept, alignment);
+
+		auto delta   = block.m_deltas.data();
+		auto address = block.m_base;
+		for (std::size_t j = 0; j < block.m_count; j++)
+		{
+			address += read_leb128(delta) * alignment;
+			if (overlaps(spans, address, address + sizeof(T)))
+			{
+				continue;
+			}
+
+			T value;
+			std::memcpy(&value, block.m_values.data() + j * sizeof(T), sizeof(T));
+			writer.add(address, value);
+		}
+
+		return kept;
+	}
+
+	template<typename F>
+	static void for_each_job(std::size_t count, F&& func)
+	{
+		if (count > 1 && big::g_thread_pool)
+		{
+			big::g_thread_pool->parallel_for(count, func);
+		}
+		else
+		{
+			for (std::size_t i = 0; i < count; i++)
+			{
+				func(i);
+			}
+		}
+	}
+
+	value_scanner::value_scanner(value_type type, region_filter filter, std::size_t alignment) :
+	    m_type(type),
+	    m_filter(filter),
+	    m_alignment(alignment ? alignment : value_size())
+	{
+	}
+
+	std::size_t value_scanner::first_scan(const value_condition& condition)
+	{
+		constexpr std::size_t chunk_size = 0x40'00'00;
+
+		reset();
+
+		if (condition.m_compare != value_compare::exact && condition.m_compare != value_compare::range)
+		{
+			return 0;
+		}
+
+		struct scan_chunk
+		{
+			uintptr_t m_begin;
+			uintptr_t m_end;
+		};
+
+		const auto regions = enumerate_regions(m_filter);
+
+		std::vector<scan_chunk> chunks;
+		for (const auto& region : regions)
+		{
+			// Regions are page aligned, so are the chunks.
+			const auto region_end = region.m_base + region.m_size;
+			for (auto begin = region.m_base; begin < region_end; begin += chunk_size)
+			{
+				chunks.push_back({begin, std::min(begin + chunk_size, region_end)});
+			}
+		}
+
+		std::vector<candidate_block> blocks(chunks.size());
+		// Address of a local of each job, to find the stacks holding copies of the value.
+		std::vector<uintptr_t> job_stacks(chunks.size());
+		visit_type(m_type,
+		           [&]<typename T>(T)
+		           {
+			           const typed_condition<T> typed(condition);
+			           for_each_job(chunks.size(),
+			                        [&](size_t i)
+			                        {
+				                        block_writer<T, candidate_block> writer(blocks[i], m_alignment);
+				                        job_stacks[i] = reinterpret_cast<uintptr_t>(&writer);
+
+				                        auto scan = [&]
+				                        {
+					                        first_scan_chunk(chunks[i].m_begin, chunks[i].m_end, m_alignment, typed, writer);
+				                        };
+
+				                        // A chunk freed during the scan keeps what it found before faulting, the next scan drops those.
+				                        run_guarded(scan);
+			                        });
+
+			           // The condition, the SSE2 needle and the candidate values are copies of the value made by the scan itself.
+			           std::vector<address_span> own_copies;
+			           job_stacks.push_back(reinterpret_cast<uintptr_t>(&typed));
+			           for (const auto stack : job_stacks)
+			           {
+				           if (const auto region = find_region(regions, stack, 1))
+				           {
+					           own_copies.push_back({region->m_base, region->m_base + region->m_size});
+				           }
+			           }
+			           for (const auto& block : blocks)
+			           {
+				           if (block.m_values.capacity())
+				           {
+					           const auto values = reinterpret_cast<uintptr_t>(block.m_values.data());
+					           own_copies.push_back({values, values + block.m_values.capacity()});
+				           }
+			           }
+			           merge_spans(own_copies);
+
+			           for (std::size_t i = 0; i < blocks.size(); i++)
+			           {
+				           if (blocks[i].m_count && overlaps(own_copies, chunks[i].m_begin, chunks[i].m_end))
+				           {
+					           blocks[i] = without_spans<T>(blocks[i], m_alignment, own_copies);
+				           }
+			           }
+		           });
+
+		std::erase_if(blocks,
+		              [](const candidate_block& block)
+		              {
+			              return block.m_count == 0;
+		              });
+
+		m_blocks = std::move(blocks);
+		for (const auto& block : m_blocks)
+		{
+			m_count += block.m_count;
+		}
+
+		return m_count;
+	}
+
+	std::size_t value_scanner::next_scan(const value_condition& condition)
+	{
+		const auto regions = enumerate_regions(m_filter);
+
+		std::vector<candidate_block> blocks(m_blocks.size());
+		visit_type(m_type,
+		           [&]<typename T>(T)
+		           {
+			           const typed_condition<T> typed(condition);
+			           for_each_job(m_blocks.size(),
+			                        [&](size_t i)
+			                        {
+				                        const auto& block = m_blocks[i];
+
+				                        block_writer<T, candidate_block> writer(blocks[i], m_alignment);
+				                        auto scan = [&]
+				                        {
+					                        auto delta          = block.m_deltas.data();
+					                        auto address        = block.m_base;
+					                        const region* owner = nullptr;
+					                        for (std::size_t j = 0; j < block.m_count; j++)
+					                        {
+						                        address += read_leb128(delta) * m_alignment;
+
+						                        if (!owner || address + sizeof(T) > owner->m_base + owner->m_size)
+						                        {
+							                        owner = find_region(regions, address, sizeof(T));
+							                        if (!owner)
+							                        {
+								                        continue;
+							                        }
+						                        }
+
+						                        T previous;
+						                        std::memcpy(&previous, block.m_values.data() + j * sizeof(T), sizeof(T));
+
+						                        const auto current = read_value<T>(address);
+						                        if (typed.matches(current, previous))
+						                        {
+							                        writer.add(address, current);
+						                        }
+					                        }
+				                        };
+
+				                        // Freed while being read: drop the whole block rather than keeping a partial one.
+				                        if (!run_guarded(scan))
+				                        {
+					                        blocks[i] = {};
+				                        }
+			                        });
+		           });
+
+		std::erase_if(blocks,
+		              [](const candidate_block& block)
+		              {
+			              return block.m_count == 0;
+		              });
+
+		m_blocks = std::move(blocks);
+		m_count  = 0;
+		for (const auto& block : m_blocks)
+		{
+			m_count += block.m_count;
+		}
+
+		return m_count;
+	}
+
+	std::size_t value_scanner::count() const
+	{
+		return m_count;
+	}
+
+	std::vector<uintptr_t> value_scanner::candidates(std::size_t max_count) const
+	{
+		std::vector<uintptr_t> result;
+		result.reserve(std::min(max_count, m_count));
+		for (const auto& block : m_blocks)
+		{
+			auto delta   = block.m_deltas.data();
+			auto address = block.m_base;
+			for (std::size_t j = 0; j < block.m_count && result.size() < max_count; j++)
+			{
+				address += read_leb128(delta) * m_alignment;
+				result.push_back(address);
+			}
+		}
+
+		return result;
+	}
+
+	void value_scanner::reset()
+	{
+		m_blocks.clear();
+		m_count = 0;
+	}
+
+	value_type value_scanner::type() const
+	{
+		return m_type;
+	}
+
+	std::size_t value_scanner::value_size() const
+	{
+		return visit_type(m_type,
+		                  []<typename T>(T)
+		                  {
+			                  return sizeof(T);
+		                  });
+	}
+} // namespace memory
@@ -0,0 +1,110 @@
+#pragma once
+#include "region.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <variant>
+#include <vector>
+
+namespace memory
+{
+	enum class value_type : uint8_t
+	{
+		u8,
+		u16,
+		u32,
+		u64,
+		i8,
+		i16,
+		i32,
+		i64,
+		f32,
+		f64,
+	};
+
+	enum class value_compare : uint8_t
+	{
+		exact,     // == m_value, within m_tolerance for floats
+		range,     // m_value <= value <= m_max
+		changed,   // != previous scan
+		unchanged, // == previous scan
+		increased, // > previous scan
+		decreased, // < previous scan
+	};
+
+	// Integers are kept apart from doubles, which only hold 53 bits: 64 bit values stay exact.
+	using scan_value = std::variant<int64_t, uint64_t, double>;
+
+	struct value_condition
+	{
+		value_compare m_compare = value_compare::exact;
+		// Converted to the scanned type, integers wrap around like they would in memory, doubles are truncated and saturated.
+		scan_value m_value     = int64_t{0};
+		scan_value m_max       = int64_t{0};
+		scan_value m_tolerance = int64_t{0};
+	};
+
+	/**
+	 * @brief Cheat Engine style value search: a first scan over the process memory, then next scans that only revisit the remaining candidates.
+	 *
+	 * Candidates are kept per scanned chunk as delta encoded (LEB128) addresses next to their value at the last scan,
+	 * a few bytes per candidate even for millions of them. Scans run on the thread pool, one chunk per job.
+	 *
+	 * The first scan drops the copies of the searched value it makes itself: the stacks of the threads running it
+	 * and the candidate buffers. Buffers freed by the scanner, like the ones of a previous scan, can still show up.
+	 */
+	class value_scanner
+	{
+	public:
+		/**
+		 * @param alignment Candidate addresses are multiples of this, 0 for the size of the type.
+		 */
+		explicit value_scanner(value_type type, region_filter filter = {region_protection::read | region_protection::write}, std::size_t alignment = 0);
+
+		/**
+		 * @brief Scans every region matching the filter, replacing the current candidates.
+		 * Only exact and range make sense here, there is no previous value to compare to yet.
+		 *
+		 * @return Candidate count.
+		 */
+		std::size_t first_scan(const value_condition& condition);
+
+		/**
+		 * @brief Keeps the candidates matching the condition and stores their current value for the next scan.
+		 * Candidates whose memory got freed since the last scan are dropped.
+		 *
+		 * @return Candidate count.
+		 */
+		std::size_t next_scan(const value_condition& condition);
+
+		std::size_t count() const;
+
+		/**
+		 * @return Address of the first candidates, in increasing order.
+		 */
+		std::vector<uintptr_t> candidates(std::size_t max_count) const;
+
+		void reset();
+
+		value_type type() const;
+		std::size_t value_size() const;
+
+	private:
+		struct candidate_block
+		{
+			// Delta base of the first candidate.
+			uintptr_t m_base;
+			std::size_t m_count;
+			// Gap to the previous candidate in units of the alignment, LEB128 encoded.
+			std::vector<uint8_t> m_deltas;
+			// Value of each candidate at the last scan.
+			std::vector<uint8_t> m_values;
+		};
+
+		value_type m_type;
+		region_filter m_filter;
+		std::size_t m_alignment;
+		std::vector<candidate_block> m_blocks;
+		std::size_t m_count{};
+	};
+} // namespace memory
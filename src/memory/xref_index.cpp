@@ -0,0 +1,384 @@
+#include "xref_index.hpp"
+
+#include "threads/thread_pool.hpp"
+
+#include <algorithm>
+#include <array>
+#include <cstring>
+#include <thread>
+
+namespace memory
+{
+	// Immediate size following the ModRM operand of each opcode, -1 for the opcodes without a ModRM byte (or not worth decoding).
+	// Only the legacy encodings are covered, VEX / EVEX and the 0F 38 / 0F 3A maps are skipped.
+	using opcode_table = std::array<int8_t, 256>;
+
+	static constexpr opcode_table make_one_byte_table()
+	{
+		opcode_table table{};
+		table.fill(-1);
+
+		// add, or, adc, sbb, and, sub, xor, cmp with a r/m operand.
+		for (int alu = 0x00; alu <= 0x38; alu += 0x08)
+		{
+			for (int i = 0; i < 4; i++)
+			{
+				table[alu + i] = 0;
+			}
+		}
+		for (int i = 0x84; i <= 0x8B; i++)
+		{
+			table[i] = 0; // test, xchg, mov
+		}
+		for (int i = 0xD0; i <= 0xD3; i++)
+		{
+			table[i] = 0; // shifts by 1 / cl
+		}
+
+		table[0x63] = 0; // movsxd
+		table[0x69] = 4; // imul r, r/m, imm32
+		table[0x6B] = 1; // imul r, r/m, imm8
+		table[0x80] = 1;
+		table[0x81] = 4;
+		table[0x83] = 1;
+		table[0x8D] = 0; // lea
+		table[0x8F] = 0; // pop r/m
+		table[0xC0] = 1;
+		table[0xC1] = 1;
+		table[0xC6] = 1; // mov r/m8, imm8
+		table[0xC7] = 4; // mov r/m, imm32
+		table[0xF6] = 1; // only test has an immediate, see decode_rip_relative
+		table[0xF7] = 4;
+		table[0xFE] = 0; // inc / dec
+		table[0xFF] = 0; // inc, dec, call, jmp, push
+		return table;
+	}
+
+	static constexpr opcode_table make_two_byte_table()
+	{
+		opcode_table table{};
+		table.fill(-1);
+
+		const auto set = [&table](int first, int last, int8_t immediate_size)
+		{
+			for (int i = first; i <= last; i++)
+			{
+				table[i] = immediate_size;
+			}
+		};
+
+		set(0x10, 0x1F, 0); // movups / movss / movlps / ..., prefetch, nop r/m
+		set(0x28, 0x2F, 0); // movaps, cvt*, ucomiss / comiss
+		set(0x40, 0x4F, 0); // cmovcc
+		set(0x50, 0x6F, 0); // sse / sse2 arithmetic, movd / movq
+		set(0x70, 0x73, 1); // pshufd, shifts by imm8
+		set(0x74, 0x76, 0); // pcmpeq
+		set(0x7E, 0x7F, 0); // movd / movq / movdqa stores
+		set(0x90, 0x9F, 0); // setcc
+		set(0xB0, 0xB1, 0); // cmpxchg
+		set(0xB6, 0xB7, 0); // movzx
+		set(0xBE, 0xBF, 0); // movsx
+		set(0xC0, 0xC1, 0); // xadd
+		set(0xD1, 0xFE, 0); // mmx / sse2 integer arithmetic
+		table[0xA3] = 0;    // bt
+		table[0xA4] = 1;    // shld imm8
+		table[0xA5] = 0;
+		table[0xAB] = 0;    // bts
+		table[0xAC] = 1;    // shrd imm8
+		table[0xAD] = 0;
+		table[0xAF] = 0;    // imul r, r/m
+		table[0xB3] = 0;    // btr
+		table[0xBA] = 1;    // bt* imm8
+		table[0xBB] = 0;    // btc
+		table[0xC2] = 1;    // cmpps
+		table[0xC4] = 1;    // pinsrw
+		table[0xC5] = 1;    // pextrw
+		table[0xC6] = 1;    // shufps
+		return table;
+	}
+
+	static constexpr auto one_byte_table = make_one_byte_table();
+	static constexpr auto two_byte_table = make_two_byte_table();
+
+	static constexpr bool is_rex(uint8_t byte)
+	{
+		return (byte & 0xF0) == 0x40;
+	}
+
+	static int32_t read_int32(const uint8_t* data)
+	{
+		int32_t value;
+		std::memcpy(&value, data, sizeof(value));
+		return value;
+	}
+
+	struct code_span
+	{
+		uint32_t m_begin;
+		uint32_t m_end;
+	};
+
+	struct decode_chunk
+	{
+		code_span m_section;
+		code_span m_owned;
+	};
+
+	static bool is_code(const std::vector<code_span>& code, int64_t rva)
+	{
+		return std::ranges::any_of(code,
+		                           [rva](const code_span& span)
+		                           {
+			                           return rva >= span.m_begin && rva < span.m_end;
+		                           });
+	}
+
+	// Start of the instruction whose opcode (0F escape included) is at opcode_rva, with its REX and an optional legacy prefix.
+	static uint32_t instruction_start(const uint8_t* image, const code_span& section, uint32_t opcode_rva, bool& operand_size_prefix)
+	{
+		auto start          = opcode_rva;
+		operand_size_prefix = false;
+		if (start > section.m_begin && is_rex(image[start - 1]))
+		{
+			start--;
+		}
+		if (start > section.m_begin)
+		{
+			const auto prefix = image[start - 1];
+			if (prefix == 0x66 || prefix == 0xF2 || prefix == 0xF3)
+			{
+				operand_size_prefix = prefix == 0x66;
+				start--;
+			}
+		}
+
+		return start;
+	}
+
+	static void decode_rip_relative(const uint8_t* image, std::size_t image_size, const code_span& section, uint32_t rva, std::vector<xref>& out)
+	{
+		const auto opcode = image[rva];
+
+		int8_t immediate_size;
+		uint32_t modrm_rva;
+		if (opcode == 0x0F)
+		{
+			if (rva + 2 >= section.m_end)
+			{
+				return;
+			}
+
+			immediate_size = two_byte_table[image[rva + 1]];
+			modrm_rva      = rva + 2;
+		}
+		else
+		{
+			// Already decoded as the second byte of a 0F instruction.
+			if (rva > section.m_begin && image[rva - 1] == 0x0F && two_byte_table[opcode] >= 0)
+			{
+				return;
+			}
+
+			immediate_size = one_byte_table[opcode];
+			modrm_rva      = rva + 1;
+		}
+
+		if (immediate_size < 0)
+		{
+			return;
+		}
+
+		// mod == 00, rm == 101: [rip + disp32].
+		const auto modrm = image[modrm_rva];
+		if ((modrm & 0xC7) != 0x05)
+		{
+			return;
+		}
+
+		if ((opcode == 0xF6 || opcode == 0xF7) && (modrm & 0x38) > 0x08)
+		{
+			immediate_size = 0;
+		}
+
+		bool operand_size_prefix;
+		const auto start = instruction_start(image, section, rva, operand_size_prefix);
+		if (operand_size_prefix && immediate_size == 4)
+		{
+			immediate_size = 2;
+		}
+
+		const auto displacement_rva = modrm_rva + 1;
+		const auto next_rva         = displacement_rva + 4 + immediate_size;
+		if (next_rva > section.m_end)
+		{
+			return;
+		}
+
+		const auto target = static_cast<int64_t>(next_rva) + read_int32(image + displacement_rva);
+		if (target < 0 || target >= static_cast<int64_t>(image_size))
+		{
+			return;
+		}
+
+		out.push_back({static_cast<uint32_t>(target), start, xref_type::rip_relative});
+	}
+
+	static void decode_chunk_xrefs(const uint8_t* image, std::size_t image_size, const std::vector<code_span>& code, const decode_chunk& chunk, std::vector<xref>& out)
+	{
+		for (auto rva = chunk.m_owned.m_begin; rva < chunk.m_owned.m_end; rva++)
+		{
+			const auto opcode = image[rva];
+			if ((opcode == 0xE8 || opcode == 0xE9) && rva + 5 <= chunk.m_section.m_end)
+			{
+				const auto target = static_cast<int64_t>(rva) + 5 + read_int32(image + rva + 1);
+				if (is_code(code, target))
+				{
+					out.push_back({static_cast<uint32_t>(target), rva, opcode == 0xE8 ? xref_type::call : xref_type::jump});
+				}
+			}
+
+			decode_rip_relative(image, image_size, chunk.m_section, rva, out);
+		}
+	}
+
+	static bool xref_less(const xref& a, const xref& b)
+	{
+		return a.m_target_rva != b.m_target_rva ? a.m_target_rva < b.m_target_rva : a.m_source_rva < b.m_source_rva;
+	}
+
+	xref_index::xref_index(const uint8_t* image, std::size_t image_size, const std::vector<pe::section_info>& sections) :
+	    m_image(image)
+	{
+		constexpr uint32_t min_chunk_size = 0x10'00'00;
+
+		std::vector<code_span> code;
+		std::size_t code_size = 0;
+		for (const auto& section : sections)
+		{
+			if (section.m_type == section_type::executable)
+			{
+				code.push_back({section.m_rva, section.m_rva + section.m_size});
+				code_size += section.m_size;
+			}
+		}
+
+		const auto thread_count = big::g_thread_pool ? std::max(1u, std::thread::hardware_concurrency()) : 1u;
+		const auto chunk_size   = static_cast<uint32_t>(std::max<std::size_t>(min_chunk_size, code_size / thread_count + 1));
+
+		std::vector<decode_chunk> chunks;
+		for (const auto& section : code)
+		{
+			for (auto begin = section.m_begin; begin < section.m_end; begin += std::min(chunk_size, section.m_end - begin))
+			{
+				chunks.push_back({section, {begin, begin + std::min(chunk_size, section.m_end - begin)}});
+			}
+		}
+
+		// Every chunk owns the opcodes inside of it and sorts its own xrefs, leaving only sorted runs to merge.
+		std::vector<std::vector<xref>> chunk_xrefs(chunks.size());
+		const auto decode = [&](size_t i)
+		{
+			decode_chunk_xrefs(image, image_size, code, chunks[i], chunk_xrefs[i]);
+			std::ranges::sort(chunk_xrefs[i], xref_less);
+		};
+
+		if (chunks.size() <= 1 || !big::g_thread_pool)
+		{
+			for (size_t i = 0; i < chunks.size(); i++)
+			{
+				decode(i);
+			}
+		}
+		else
+		{
+			big::g_thread_pool->parallel_for(chunks.size(), decode);
+		}
+
+		std::size_t total = 0;
+		for (const auto& xrefs : chunk_xrefs)
+		{
+			total += xrefs.size();
+		}
+
+		std::vector<std::size_t> run_ends;
+		m_xrefs.reserve(total);
+		for (auto& xrefs : chunk_xrefs)
+		{
+			m_xrefs.insert(m_xrefs.end(), xrefs.begin(), xrefs.end());
+			run_ends.push_back(m_xrefs.size());
+			xrefs = {};
+		}
+
+		while (run_ends.size() > 1)
+		{
+			std::vector<std::size_t> merged_ends;
+			std::size_t begin = 0;
+			for (size_t i = 0; i + 1 < run_ends.size(); i += 2)
+			{
+				std::inplace_merge(m_xrefs.begin() + begin, m_xrefs.begin() + run_ends[i], m_xrefs.begin() + run_ends[i + 1], xref_less);
+				begin = run_ends[i + 1];
+				merged_ends.push_back(begin);
+			}
+			if (run_ends.size() % 2)
+			{
+				merged_ends.push_back(run_ends.back());
+			}
+
+			run_ends = std::move(merged_ends);
+		}
+	}
+
+	xref_index::xref_index(const uint8_t* image, std::vector<xref> xrefs) :
+	    m_image(image),
+	    m_xrefs(std::move(xrefs))
+	{
+	}
+
+	std::span<const xref> xref_index::references_to(uint32_t target_rva) const
+	{
+		const auto [first, last] = std::ranges::equal_range(m_xrefs, target_rva, std::less{}, &xref::m_target_rva);
+		return {first, last};
+	}
+
+	std::vector<handle> xref_index::callers(handle function) const
+	{
+		std::vector<handle> result;
+		const auto target_rva = function.as<uintptr_t>() - reinterpret_cast<uintptr_t>(m_image);
+		if (target_rva > UINT32_MAX)
+		{
+			return result;
+		}
+
+		for (const auto& xref : references_to(static_cast<uint32_t>(target_rva)))
+		{
+			if (xref.m_type == xref_type::call)
+			{
+				result.push_back(handle(const_cast<uint8_t*>(m_image + xref.m_source_rva)));
+			}
+		}
+
+		return result;
+	}
+
+	std::vector<handle> xref_index::references(handle target) const
+	{
+		std::vector<handle> result;
+		const auto target_rva = target.as<uintptr_t>() - reinterpret_cast<uintptr_t>(m_image);
+		if (target_rva > UINT32_MAX)
+		{
+			return result;
+		}
+
+		for (const auto& xref : references_to(static_cast<uint32_t>(target_rva)))
+		{
+			result.push_back(handle(const_cast<uint8_t*>(m_image + xref.m_source_rva)));
+		}
+
+		return result;
+	}
+
+	const std::vector<xref>& xref_index::xrefs() const
+	{
+		return m_xrefs;
+	}
+} // namespace memory
@@ -0,0 +1,67 @@
+#pragma once
+#include "handle.hpp"
+#include "pe.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <vector>
+
+namespace memory
+{
+	enum class xref_type : uint32_t
+	{
+		call,         // E8 rel32
+		jump,         // E9 rel32
+		rip_relative, // [rip + disp32] memory operand, including call / jmp qword ptr [rip + disp32]
+	};
+
+	struct xref
+	{
+		uint32_t m_target_rva;
+		// Start of the referencing instruction, prefixes included.
+		uint32_t m_source_rva;
+		xref_type m_type;
+	};
+
+	/**
+	 * @brief Code references of an image, sorted by target: rel32 call / jmp targets and RIP-relative memory operands.
+	 *
+	 * Executable sections are decoded at every byte offset instead of following the control flow, the same brute force approach as IDA's
+	 * "search for references". Candidates only get indexed when their target lands in the image (in code for call / jmp), so a stray
+	 * reference has to hit the exact queried address to show up.
+	 */
+	class xref_index
+	{
+	public:
+		/**
+		 * @brief Decodes the executable sections in parallel chunks on the thread pool.
+		 *
+		 * @param image Start of the image laid out at its rvas, a loaded module or a pe_image.
+		 */
+		xref_index(const uint8_t* image, std::size_t image_size, const std::vector<pe::section_info>& sections);
+
+		/**
+		 * @brief Index restored from a previous build of the same image, xrefs must already be sorted.
+		 */
+		xref_index(const uint8_t* image, std::vector<xref> xrefs);
+
+		/**
+		 * @brief O(log n).
+		 *
+		 * @return Every reference to the rva, sorted by source.
+		 */
+		std::span<const xref> references_to(uint32_t target_rva) const;
+
+		// Addresses of the call instructions targeting the function.
+		std::vector<handle> callers(handle function) const;
+		// Addresses of every instruction referencing the target, whatever the type.
+		std::vector<handle> references(handle target) const;
+
+		const std::vector<xref>& xrefs() const;
+
+	private:
+		const uint8_t* m_image;
+		std::vector<xref> m_xrefs;
+	};
+} // namespace memory
@@ -0,0 +1,106 @@
+#include "xref_index_cache.hpp"
+
+#include <algorithm>
+
+namespace memory
+{
+	// Bump when the decoding rules or the xref layout change.
+	static constexpr uint64_t xref_cache_version = 1;
+
+	void xref_index_cache::set_folder(const std::filesystem::path& folder)
+	{
+		std::scoped_lock lock(m_lock);
+		m_folder = folder;
+	}
+
+	std::shared_ptr<const xref_index> xref_index_cache::load_or_build(const module& mod, const std::filesystem::path& folder)
+	{
+		const auto image = mod.begin().as<const uint8_t*>();
+
+		module_cache_file<xref> cache_file(folder, mod.name(), module_file_version(mod.timestamp(), mod.size()), "xrefs", xref_cache_version);
+		if (auto xrefs = cache_file.load())
+		{
+			return std::make_shared<const xref_index>(image, std::move(*xrefs));
+		}
+
+		auto index = std::make_shared<const xref_index>(image, mod.size(), pe::read_sections(image, mod.size()));
+		cache_file.write(index->xrefs());
+		return index;
+	}
+
+	std::shared_ptr<const xref_index> xref_index_cache::get(const module& mod)
+	{
+		std::filesystem::path folder;
+		{
+			std::scoped_lock lock(m_lock);
+			if (const auto& entry = m_indices.get(mod); entry.m_index)
+			{
+				return entry.m_index;
+			}
+
+			folder = m_folder;
+		}
+
+		// Built without the lock, queries on the other indices keep working meanwhile.
+		auto index = load_or_build(mod, folder);
+
+		std::scoped_lock lock(m_lock);
+		m_indices.get(mod).m_index = index;
+		return index;
+	}
+
+	std::shared_ptr<const string_index> xref_index_cache::strings(const module& mod)
+	{
+		{
+			std::scoped_lock lock(m_lock);
+			if (const auto& entry = m_indices.get(mod); entry.m_strings)
+			{
+				return entry.m_strings;
+			}
+		}
+
+		const auto image = mod.begin().as<const uint8_t*>();
+		auto strings     = std::make_shared<const string_index>(image, pe::read_sections(image, mod.size()));
+
+		std::scoped_lock lock(m_lock);
+		m_indices.get(mod).m_strings = strings;
+		return strings;
+	}
+
+	std::vector<handle> xref_index_cache::string_references(const module& mod, std::string_view str)
+	{
+		std::vector<handle> result;
+
+		const auto string_rvas = strings(mod)->find(str);
+		if (string_rvas.empty())
+		{
+			return result;
+		}
+
+		const auto index = get(mod);
+		for (const auto string_rva : string_rvas)
+		{
+			for (const auto& xref : index->references_to(string_rva))
+			{
+				if (xref.m_type == xref_type::rip_relative)
+				{
+					result.push_back(mod.begin().add(xref.m_source_rva));
+				}
+			}
+		}
+
+		std::ranges::sort(result,
+		                  [](handle a, handle b)
+		                  {
+			                  return a.as<uintptr_t>() < b.as<uintptr_t>();
+		                  });
+		return result;
+	}
+
+	std::shared_ptr<const xref_index> xref_index_cache::find(handle address)
+	{
+		std::scoped_lock lock(m_lock);
+		const auto entry = m_indices.find(address.as<uintptr_t>());
+		return entry ? entry->m_index : nullptr;
+	}
+} // namespace memory
@@ -0,0 +1,71 @@
+#pragma once
+#include "handle.hpp"
+#include "module.hpp"
+#include "module_cache.hpp"
+#include "string_index.hpp"
+#include "xref_index.hpp"
+
+#include <filesystem>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace memory
+{
+	/**
+	 * @brief Opt-in xref and string indices of loaded modules, built once per module build.
+	 * The xref indices are persisted next to the pattern cache, the string ones are cheap enough to rebuild on each run.
+	 */
+	class xref_index_cache
+	{
+	public:
+		/**
+		 * @brief Folder holding the cache files. Indices are only kept in memory until this is set.
+		 */
+		void set_folder(const std::filesystem::path& folder);
+
+		/**
+		 * @brief Index of the module, loaded from its cache file when it was written for the same build, built otherwise.
+		 * Building decodes the whole code of the module, expect it to take a while on large images.
+		 */
+		std::shared_ptr<const xref_index> get(const module& mod);
+
+		/**
+		 * @brief Already built index of the module containing the address.
+		 *
+		 * @return nullptr if no index covers the address, nothing gets built here.
+		 */
+		std::shared_ptr<const xref_index> find(handle address);
+
+		/**
+		 * @brief String literals of the read-only data sections of the module, built on first use.
+		 */
+		std::shared_ptr<const string_index> strings(const module& mod);
+
+		/**
+		 * @brief Code referencing a string literal of the module through a RIP-relative operand, such as lea rcx, [rip + str].
+		 * Builds the string and xref indices of the module on first use.
+		 *
+		 * @param str Exact content of the literal, matched against narrow and UTF-16 literals.
+		 * @return Address of each referencing instruction, sorted.
+		 */
+		std::vector<handle> string_references(const module& mod, std::string_view str);
+
+	private:
+		struct module_entry
+		{
+			std::shared_ptr<const xref_index> m_index;
+			std::shared_ptr<const string_index> m_strings;
+		};
+
+		std::shared_ptr<const xref_index> load_or_build(const module& mod, const std::filesystem::path& folder);
+
+		std::mutex m_lock;
+		std::filesystem::path m_folder;
+		module_entries<module_entry> m_indices;
+	};
+
+	inline auto g_xref_index_cache = xref_index_cache();
+} // namespace memory
@@ -57,6 +57,73 @@ namespace big
 		}
 	}
 
+	void thread_pool::parallel_for(size_t count, std::function<void(size_t)> func)
+	{
+		if (!count)
+		{
+			return;
+		}
+
+		struct parallel_for_state
+		{
+			std::function<void(size_t)> m_func;
+			size_t m_count;
+			std::atomic<size_t> m_next_index;
+			std::atomic<size_t> m_done_count;
+			std::mutex m_done_lock;
+			std::condition_variable m_done_condition;
+		};
+
+		// Shared so that pool threads starting after the caller returned only see an exhausted range.
+		auto state          = std::make_shared<parallel_for_state>();
+		state->m_func       = std::move(func);
+		state->m_count      = count;
+		state->m_next_index = 0;
+		state->m_done_count = 0;
+
+		auto worker = [state]
+		{
+			for (;;)
+			{
+				const auto index = state->m_next_index++;
+				if (index >= state->m_count)
+				{
+					return;
+				}
+
+				try
+				{
+					state->m_func(index);
+				}
+				catch (const std::exception& e)
+				{
+					LOG(WARNING) << "Exception thrown while executing parallel_for job:" << std::endl << e.what();
+				}
+
+				if (++state->m_done_count == state->m_count)
+				{
+					std::scoped_lock lock(state->m_done_lock);
+					state->m_done_condition.notify_all();
+				}
+			}
+		};
+
+		const auto helper_count = std::min<size_t>(count - 1, m_allocated_thread_count);
+		for (size_t i = 0; i < helper_count; i++)
+		{
+			push(worker);
+		}
+
+		worker();
+
+		std::unique_lock lock(state->m_done_lock);
+		state->m_done_condition.wait(lock,
+		                             [&state]
+		                             {
+			                             return state->m_done_count == state->m_count;
+		                             });
+	}
+
 	void thread_pool::run()
 	{
 		for (;;)
@@ -37,6 +37,10 @@ namespace big
 		void destroy();
 		void push(std::function<void()> func, std::source_location location = std::source_location::current());
 
+		// Calls func for every index in [0, count), spread over the pool. The calling thread takes part in the work too,
+		// so this never waits on a busy pool. Indices are handed out in increasing order. Returns once all of them are processed.
+		void parallel_for(size_t count, std::function<void(size_t)> func);
+
 		std::pair<size_t, size_t> usage() const
 		{
 			return {m_busy_threads, m_allocated_thread_count};
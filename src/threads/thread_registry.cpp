@@ -0,0 +1,169 @@
+#include "thread_registry.hpp"
+
+#include <algorithm>
+
+#if defined(_WIN32)
+	#include "memory/module.hpp"
+	#include "threads/util.hpp"
+#else
+	#include <charconv>
+	#include <filesystem>
+	#include <string>
+#endif
+
+namespace big::threads
+{
+#if defined(_WIN32)
+	using NtGetNextThread_t = LONG(NTAPI*)(HANDLE process, HANDLE thread, ACCESS_MASK desired_access, ULONG handle_attributes, ULONG flags, PHANDLE new_thread);
+
+	// Calls on_thread with an opened handle of each thread of the process, on_thread returns true to keep the handle.
+	template<typename F>
+	static void enumerate_threads(F&& on_thread)
+	{
+		static const auto nt_get_next_thread = reinterpret_cast<NtGetNextThread_t>(GetProcAddress(GetModuleHandleA("ntdll.dll"), "NtGetNextThread"));
+		if (!nt_get_next_thread)
+		{
+			return;
+		}
+
+		// SYNCHRONIZE lets has_exited wait on the handle.
+		constexpr ACCESS_MASK access = THREAD_SUSPEND_RESUME | THREAD_QUERY_INFORMATION | SYNCHRONIZE;
+
+		// Each call continues from the previous handle, which can only be closed once the next one is returned.
+		HANDLE current = nullptr;
+		bool kept      = true;
+		for (;;)
+		{
+			HANDLE next = nullptr;
+			if (nt_get_next_thread(GetCurrentProcess(), current, access, 0, 0, &next) != 0)
+			{
+				break;
+			}
+
+			if (!kept)
+			{
+				CloseHandle(current);
+			}
+
+			current = next;
+			kept    = on_thread(GetThreadId(next), next);
+		}
+
+		if (!kept)
+		{
+			CloseHandle(current);
+		}
+	}
+
+	static void close_thread(thread_handle handle)
+	{
+		CloseHandle(handle);
+	}
+
+	// A thread handle is signaled once the thread exited, its id can then be reused by a new thread.
+	static bool has_exited(thread_handle handle)
+	{
+		return WaitForSingleObject(handle, 0) == WAIT_OBJECT_0;
+	}
+
+	static bool is_system_thread(thread_handle handle)
+	{
+		static const auto ntdll = memory::module("ntdll.dll");
+
+		const auto start_address = get_thread_start_address(handle);
+		return start_address >= ntdll.begin().as<PVOID>() && start_address < ntdll.end().as<PVOID>();
+	}
+#else
+	template<typename F>
+	static void enumerate_threads(F&& on_thread)
+	{
+		std::error_code error;
+		for (const auto& entry : std::filesystem::directory_iterator("/proc/self/task", error))
+		{
+			const auto name = entry.path().filename().string();
+
+			thread_id id{};
+			if (std::from_chars(name.data(), name.data() + name.size(), id).ec == std::errc())
+			{
+				on_thread(id, id);
+			}
+		}
+	}
+
+	static void close_thread(thread_handle)
+	{
+	}
+
+	// The id is all there is, a reused id can't be told apart from the thread that had it.
+	static bool has_exited(thread_handle)
+	{
+		return false;
+	}
+
+	static bool is_system_thread(thread_handle)
+	{
+		return false;
+	}
+#endif
+
+	thread_registry::~thread_registry()
+	{
+		for (const auto& thread : m_threads)
+		{
+			close_thread(thread.m_handle);
+		}
+	}
+
+	void thread_registry::refresh()
+	{
+		std::scoped_lock lock(m_lock);
+
+		std::vector<registered_thread> alive;
+		alive.reserve(m_threads.size());
+
+		// m_threads stays sorted by id between refreshes.
+		enumerate_threads(
+		    [&](thread_id id, thread_handle handle)
+		    {
+			    const auto it = std::ranges::lower_bound(m_threads, id, {}, &registered_thread::m_id);
+			    if (it != m_threads.end() && it->m_id == id && !has_exited(it->m_handle))
+			    {
+				    // Known thread: keep its handle and state, the freshly opened handle is dropped.
+				    alive.push_back(*it);
+				    it->m_handle = thread_handle{};
+				    return false;
+			    }
+
+			    // New thread, possibly reusing the id of an exited one whose stale handle gets closed below.
+			    alive.push_back({id, handle, is_system_thread(handle), false});
+			    return true;
+		    });
+
+		// Whatever was not enumerated again has exited.
+		for (const auto& thread : m_threads)
+		{
+			if (thread.m_handle != thread_handle{})
+			{
+				close_thread(thread.m_handle);
+			}
+		}
+
+		std::ranges::sort(alive, {}, &registered_thread::m_id);
+		m_threads = std::move(alive);
+	}
+
+	void thread_registry::for_each(const std::function<void(registered_thread&)>& func)
+	{
+		std::scoped_lock lock(m_lock);
+		for (auto& thread : m_threads)
+		{
+			func(thread);
+		}
+	}
+
+	std::size_t thread_registry::size()
+	{
+		std::scoped_lock lock(m_lock);
+		return m_threads.size();
+	}
+} // namespace big::threads
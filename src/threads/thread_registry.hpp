@@ -0,0 +1,69 @@
+#pragma once
+
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <vector>
+
+#if defined(_WIN32)
+	#include <windows.h>
+#else
+	#include <sys/types.h>
+#endif
+
+namespace big::threads
+{
+#if defined(_WIN32)
+	using thread_id     = DWORD;
+	using thread_handle = HANDLE;
+#else
+	using thread_id     = pid_t;
+	// /proc/self/task only gives ids, there is nothing to open.
+	using thread_handle = pid_t;
+#endif
+
+	struct registered_thread
+	{
+		thread_id m_id;
+		// Opened once when the thread is first seen, reused by every suspend / resume cycle.
+		thread_handle m_handle;
+		// Started by the OS rather than the game (ntdll thread pool workers and such), never suspended.
+		bool m_system;
+		// Suspended by suspend_all_but_one, resumed by the next resume_all.
+		bool m_suspended;
+	};
+
+	/**
+	 * @brief Threads of the current process, kept across suspend / resume cycles.
+	 *
+	 * refresh() only walks the threads of this process (NtGetNextThread on Windows, /proc/self/task elsewhere) instead of
+	 * snapshotting every thread of the system. It is not incremental: every refresh enumerates all the threads again, and
+	 * NtGetNextThread opens a handle to each of them. Threads seen before keep their first handle and state, the new handle
+	 * is closed right away. New threads get their handle kept and their start address checked, exited ones are closed.
+	 * On Windows an id reused by a new thread is detected by the old handle being signaled, the entry is then replaced.
+	 */
+	class thread_registry
+	{
+	public:
+		thread_registry() = default;
+		~thread_registry();
+
+		thread_registry(const thread_registry&)            = delete;
+		thread_registry& operator=(const thread_registry&) = delete;
+
+		void refresh();
+
+		/**
+		 * @brief Calls func on every registered thread, sorted by id, with the registry locked.
+		 */
+		void for_each(const std::function<void(registered_thread&)>& func);
+
+		std::size_t size();
+
+	private:
+		std::mutex m_lock;
+		std::vector<registered_thread> m_threads;
+	};
+
+	inline thread_registry g_thread_registry;
+} // namespace big::threads
@@ -1,14 +1,12 @@
 #pragma once
 #include "threads/util.hpp"
 
-#include "memory/module.hpp"
+#include "threads/thread_registry.hpp"
 
 namespace big::threads
 {
 	bool are_suspended = false;
 
-	static ankerl::unordered_dense::set<DWORD> g_ntdll_thread_ids;
-
 	PVOID get_thread_start_address(HANDLE hThread)
 	{
 		typedef LONG NTSTATUS;
@@ -41,64 +39,10 @@ namespace big::threads
 		return dwStartAddress;
 	}
 
-	static void fill_current_process_ntdll_thread_cache()
-	{
-		const auto current_process_id = GetCurrentProcessId();
-
-		HANDLE hModuleSnap = CreateToolhelp32Snapshot(TH32CS_SNAPMODULE, current_process_id);
-		if (hModuleSnap == INVALID_HANDLE_VALUE)
-		{
-			return;
-		}
-
-		HANDLE hThreadSnap = CreateToolhelp32Snapshot(TH32CS_SNAPTHREAD, 0);
-		if (hThreadSnap == INVALID_HANDLE_VALUE)
-		{
-			CloseHandle(hModuleSnap);
-			return;
-		}
-
-		THREADENTRY32 te;
-		te.dwSize = sizeof(te);
-		if (!Thread32First(hThreadSnap, &te))
-		{
-			CloseHandle(hThreadSnap);
-			CloseHandle(hModuleSnap);
-			return;
-		}
-
-		const auto ntdll_module_info = memory::module("ntdll.dll");
-
-		do
-		{
-			if (te.dwSize >= FIELD_OFFSET(THREADENTRY32, th32OwnerProcessID) + sizeof(te.th32OwnerProcessID) && te.th32OwnerProcessID == current_process_id)
-			{
-				HANDLE hThread = OpenThread(THREAD_ALL_ACCESS, FALSE, te.th32ThreadID);
-				if (hThread)
-				{
-					const auto thread_start_address = get_thread_start_address(hThread);
-					if (thread_start_address >= ntdll_module_info.begin().as<PVOID>()
-					    && thread_start_address < ntdll_module_info.end().as<PVOID>())
-					{
-						g_ntdll_thread_ids.insert(te.th32ThreadID);
-					}
-
-					CloseHandle(hThread);
-				}
-			}
-		} while (Thread32Next(hThreadSnap, &te));
-
-		CloseHandle(hThreadSnap);
-		CloseHandle(hModuleSnap);
-	}
-
-	void resume_all(DWORD target_process_id, DWORD thread_id_to_not_suspend)
+	// Other processes still go through a system wide snapshot, the registry only knows the threads of this one.
+	template<typename F>
+	static void for_each_thread_of(DWORD target_process_id, F&& func)
 	{
-		if (g_ntdll_thread_ids.empty() && target_process_id == GetCurrentProcessId())
-		{
-			fill_current_process_ntdll_thread_cache();
-		}
-
 		HANDLE h = CreateToolhelp32Snapshot(TH32CS_SNAPTHREAD, 0);
 		if (h != INVALID_HANDLE_VALUE)
 		{
@@ -108,18 +52,12 @@ namespace big::threads
 			{
 				do
 				{
-					// clang-format off
-					if (te.dwSize >= FIELD_OFFSET(THREADENTRY32, th32OwnerProcessID) + sizeof(te.th32OwnerProcessID) &&
-						te.th32OwnerProcessID == target_process_id &&
-						!g_rom_thread_ids.contains(te.th32ThreadID) &&
-						!g_ntdll_thread_ids.contains(te.th32ThreadID))
-					// clang-format on
+					if (te.dwSize >= FIELD_OFFSET(THREADENTRY32, th32OwnerProcessID) + sizeof(te.th32OwnerProcessID) && te.th32OwnerProcessID == target_process_id)
 					{
-						HANDLE hThread = OpenThread(THREAD_ALL_ACCESS, FALSE, te.th32ThreadID);
+						HANDLE hThread = OpenThread(THREAD_SUSPEND_RESUME, FALSE, te.th32ThreadID);
 						if (hThread)
 						{
-							ResumeThread(hThread);
-							are_suspended = false;
+							func(te.th32ThreadID, hThread);
 							CloseHandle(hThread);
 						}
 					}
@@ -129,41 +67,62 @@ namespace big::threads
 		}
 	}
 
-	void suspend_all_but_one(DWORD target_process_id, DWORD thread_id_to_not_suspend)
+	void resume_all(DWORD target_process_id, DWORD thread_id_to_not_suspend)
 	{
-		if (g_ntdll_thread_ids.empty() && target_process_id == GetCurrentProcessId())
+		if (target_process_id != GetCurrentProcessId())
 		{
-			fill_current_process_ntdll_thread_cache();
+			for_each_thread_of(target_process_id,
+			                   [](DWORD, HANDLE thread)
+			                   {
+				                   ResumeThread(thread);
+			                   });
+			are_suspended = false;
+			return;
 		}
 
-		HANDLE h = CreateToolhelp32Snapshot(TH32CS_SNAPTHREAD, 0);
-		if (h != INVALID_HANDLE_VALUE)
+		// Only the threads suspended by the last suspend_all_but_one, no refresh needed.
+		g_thread_registry.for_each(
+		    [](registered_thread& thread)
+		    {
+			    if (thread.m_suspended)
+			    {
+				    ResumeThread(thread.m_handle);
+				    thread.m_suspended = false;
+			    }
+		    });
+		are_suspended = false;
+	}
+
+	void suspend_all_but_one(DWORD target_process_id, DWORD thread_id_to_not_suspend)
+	{
+		if (target_process_id != GetCurrentProcessId())
 		{
-			THREADENTRY32 te;
-			te.dwSize = sizeof(te);
-			if (Thread32First(h, &te))
-			{
-				do
-				{
-					// clang-format off
-					if (te.dwSize >= FIELD_OFFSET(THREADENTRY32, th32OwnerProcessID) + sizeof(te.th32OwnerProcessID) &&
-						te.th32OwnerProcessID == target_process_id &&
-						te.th32ThreadID != thread_id_to_not_suspend &&
-						!g_rom_thread_ids.contains(te.th32ThreadID) &&
-						!g_ntdll_thread_ids.contains(te.th32ThreadID))
-					// clang-format on
-					{
-						HANDLE hThread = OpenThread(THREAD_ALL_ACCESS, FALSE, te.th32ThreadID);
-						if (hThread)
-						{
-							SuspendThread(hThread);
-							are_suspended = true;
-							CloseHandle(hThread);
-						}
-					}
-				} while (Thread32Next(h, &te));
-			}
-			CloseHandle(h);
+			for_each_thread_of(target_process_id,
+			                   [&](DWORD thread_id, HANDLE thread)
+			                   {
+				                   if (thread_id != thread_id_to_not_suspend)
+				                   {
+					                   SuspendThread(thread);
+				                   }
+			                   });
+			are_suspended = true;
+			return;
 		}
+
+		g_thread_registry.refresh();
+		g_thread_registry.for_each(
+		    [&](registered_thread& thread)
+		    {
+			    if (thread.m_id == thread_id_to_not_suspend || thread.m_system || thread.m_suspended || g_rom_thread_ids.contains(thread.m_id))
+			    {
+				    return;
+			    }
+
+			    if (SuspendThread(thread.m_handle) != static_cast<DWORD>(-1))
+			    {
+				    thread.m_suspended = true;
+			    }
+		    });
+		are_suspended = true;
 	}
 } // namespace big::threads
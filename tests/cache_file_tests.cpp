@@ -0,0 +1,84 @@
+#include "check.hpp"
+#include "file_manager/cache_file.hpp"
+
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+
+using namespace big;
+
+namespace
+{
+	const auto cache_path = std::filesystem::temp_directory_path() / "rom_cache_file_tests.bin";
+
+	void write_cache(uint64_t data_size)
+	{
+		auto data = std::make_unique<uint8_t[]>(data_size);
+		for (uint64_t i = 0; i < data_size; i++)
+		{
+			data[i] = static_cast<uint8_t>(i);
+		}
+
+		cache_file cache(file(cache_path), 3);
+		cache.set_data(std::move(data), data_size);
+		cache.set_header_version(42);
+		CHECK(cache.write());
+	}
+
+	void test_round_trip()
+	{
+		write_cache(100);
+
+		cache_file cache(file(cache_path), 3);
+		CHECK(cache.load());
+		CHECK(cache.up_to_date(42));
+		CHECK(!cache.up_to_date(43));
+		CHECK(cache.data_size() == 100);
+		CHECK(cache.data() && cache.data()[99] == 99);
+	}
+
+	void test_truncated_file_is_a_miss()
+	{
+		write_cache(100);
+		std::filesystem::resize_file(cache_path, sizeof(cache_header) + 50);
+
+		cache_file cache(file(cache_path), 3);
+		CHECK(!cache.load());
+		CHECK(!cache.up_to_date(42));
+
+		// Shorter than the header itself.
+		std::filesystem::resize_file(cache_path, 5);
+		CHECK(!cache.load());
+	}
+
+	// A corrupted size must not be allocated, it would throw bad_alloc.
+	void test_corrupted_size_is_a_miss()
+	{
+		write_cache(100);
+
+		cache_header header{};
+		{
+			std::ifstream in(cache_path, std::ios::binary);
+			in.read(reinterpret_cast<char*>(&header), sizeof(header));
+		}
+		header.m_data_size = 0xFF'FF'FF'FF'FF'FF'00;
+		{
+			std::fstream out(cache_path, std::ios::binary | std::ios::in | std::ios::out);
+			out.write(reinterpret_cast<const char*>(&header), sizeof(header));
+		}
+
+		cache_file cache(file(cache_path), 3);
+		CHECK(!cache.load());
+		CHECK(!cache.data());
+	}
+} // namespace
+
+int main()
+{
+	test_round_trip();
+	test_truncated_file_is_a_miss();
+	test_corrupted_size_is_a_miss();
+
+	std::filesystem::remove(cache_path);
+	return CHECK_RESULT();
+}
@@ -0,0 +1,18 @@
+#pragma once
+#include <cstdio>
+#include <cstdlib>
+
+// Minimal assertions for the portable tests: every failure is reported, the test fails if any did.
+inline int g_check_failures = 0;
+
+#define CHECK(condition)                                                                      \
+	do                                                                                        \
+	{                                                                                         \
+		if (!(condition))                                                                     \
+		{                                                                                     \
+			std::fprintf(stderr, "%s:%d: CHECK(%s) failed\n", __FILE__, __LINE__, #condition); \
+			g_check_failures++;                                                               \
+		}                                                                                     \
+	} while (false)
+
+#define CHECK_RESULT() (g_check_failures ? EXIT_FAILURE : EXIT_SUCCESS)
@@ -0,0 +1,102 @@
+#!/usr/bin/env python3
+"""Writes tiny.dll, the PE32+ image used by pe_tests: three sections and imports by name and by ordinal.
+
+Nothing in it is meant to run, only the layout matters. Rerun after changing it and update pe_tests.cpp to match.
+"""
+import struct
+
+FILE_ALIGNMENT = 0x200
+SECTION_ALIGNMENT = 0x1000
+TIMESTAMP = 0x5EADBEEF
+IMAGE_BASE = 0x180000000
+
+MEM_EXECUTE, MEM_READ, MEM_WRITE = 0x20000000, 0x40000000, 0x80000000
+CNT_CODE, CNT_INITIALIZED_DATA = 0x20, 0x40
+
+
+def build_rdata(rva):
+    """Import directory for KERNEL32.dll (GetProcAddress, LoadLibraryA) and WS2_32.dll (ordinal 23)."""
+    imports = [("KERNEL32.dll", ["GetProcAddress", "LoadLibraryA"]), ("WS2_32.dll", [23])]
+
+    descriptors_size = 20 * (len(imports) + 1)
+    thunk_tables_size = sum(8 * (len(symbols) + 1) for _, symbols in imports)
+    names_offset = descriptors_size + 2 * thunk_tables_size
+
+    names = bytearray()
+    name_rvas = {}
+    for dll, symbols in imports:
+        for symbol in symbols:
+            if isinstance(symbol, str):
+                name_rvas[symbol] = rva + names_offset + len(names)
+                names += struct.pack("<H", 0) + symbol.encode() + b"\0"
+                names += b"\0" * (len(names) % 2)
+        name_rvas[dll] = rva + names_offset + len(names)
+        names += dll.encode() + b"\0"
+
+    descriptors = bytearray()
+    lookup_tables = bytearray()
+    address_tables = bytearray()
+    for dll, symbols in imports:
+        thunks = b"".join(struct.pack("<Q", name_rvas[s] if isinstance(s, str) else (1 << 63) | s) for s in symbols) + b"\0" * 8
+        lookup_rva = rva + descriptors_size + len(lookup_tables)
+        address_rva = rva + descriptors_size + thunk_tables_size + len(address_tables)
+        descriptors += struct.pack("<IIIII", lookup_rva, 0, 0, name_rvas[dll], address_rva)
+        lookup_tables += thunks
+        address_tables += thunks
+    descriptors += b"\0" * 20
+
+    data = descriptors + lookup_tables + address_tables + names
+    return data, (rva, descriptors_size), (rva + descriptors_size + thunk_tables_size, thunk_tables_size)
+
+
+def align(value, alignment):
+    return (value + alignment - 1) // alignment * alignment
+
+
+def main():
+    text = bytes.fromhex("48 8B 05 F9 0F 00 00 48 85 C0 74 02 FF E0 C3".replace(" ", "")) + b"\xCC" * 17
+    rdata, import_directory, iat_directory = build_rdata(0x2000)
+    data = struct.pack("<QQ", 0x1122334455667788, 0)
+
+    # name, rva, virtual size, raw data, characteristics
+    sections = [
+        (b".text", 0x1000, len(text), text, CNT_CODE | MEM_EXECUTE | MEM_READ),
+        (b".rdata", 0x2000, len(rdata), rdata, CNT_INITIALIZED_DATA | MEM_READ),
+        (b".data", 0x3000, 0x80, data, CNT_INITIALIZED_DATA | MEM_READ | MEM_WRITE),
+    ]
+
+    dos = bytearray(64)
+    struct.pack_into("<H", dos, 0, 0x5A4D)
+    struct.pack_into("<i", dos, 60, 64)
+
+    directories = [(0, 0)] * 16
+    directories[1] = import_directory
+    directories[12] = iat_directory
+
+    size_of_headers = align(64 + 264 + 40 * len(sections), FILE_ALIGNMENT)
+    size_of_image = align(sections[-1][1] + sections[-1][2], SECTION_ALIGNMENT)
+
+    optional = struct.pack(
+        "<HBBIIIIIQII6HIIIIHH4QII",
+        0x20B, 14, 0, align(len(text), FILE_ALIGNMENT), 2 * FILE_ALIGNMENT, 0, 0x1000, 0x1000,
+        IMAGE_BASE, SECTION_ALIGNMENT, FILE_ALIGNMENT, 6, 0, 0, 0, 6, 0, 0,
+        size_of_image, size_of_headers, 0, 3, 0x160, 0x100000, 0x1000, 0x100000, 0x1000, 0, 16,
+    ) + b"".join(struct.pack("<II", *d) for d in directories)
+    file_header = struct.pack("<HHIIIHH", 0x8664, len(sections), TIMESTAMP, 0, 0, len(optional), 0x2022)
+
+    headers = dos + struct.pack("<I", 0x4550) + file_header + optional
+    raw = bytearray()
+    raw_offset = size_of_headers
+    for name, rva, virtual_size, content, characteristics in sections:
+        raw_size = align(len(content), FILE_ALIGNMENT)
+        headers += struct.pack("<8sIIIIIIHHI", name, virtual_size, rva, raw_size, raw_offset, 0, 0, 0, 0, characteristics)
+        raw += content + b"\0" * (raw_size - len(content))
+        raw_offset += raw_size
+
+    headers += b"\0" * (size_of_headers - len(headers))
+    with open("tiny.dll", "wb") as f:
+        f.write(headers + raw)
+
+
+if __name__ == "__main__":
+    main()
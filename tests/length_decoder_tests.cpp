@@ -0,0 +1,203 @@
+#include "check.hpp"
+#include "memory/length_decoder.hpp"
+#include "memory/pattern.hpp"
+#include "memory/pe_image.hpp"
+#include "memory/range.hpp"
+#include "memory/signature_generator.hpp"
+
+#include <cstdio>
+#include <cstring>
+#include <initializer_list>
+#include <vector>
+
+using namespace memory;
+
+namespace
+{
+	struct encoding
+	{
+		const char* m_text;
+		std::initializer_list<uint8_t> m_bytes;
+		uint8_t m_length;
+		// 0 when there is none.
+		uint8_t m_displacement_offset = 0;
+		uint8_t m_immediate_offset    = 0;
+		uint8_t m_immediate_size      = 0;
+		bool m_rip_relative           = false;
+		bool m_relative_immediate     = false;
+	};
+
+	// Displacements and immediates are arbitrary, only their sizes matter.
+	const encoding corpus[] = {
+	    {"nop", {0x90}, 1},
+	    {"ret", {0xC3}, 1},
+	    {"ret 8", {0xC2, 0x08, 0x00}, 3, 0, 1, 2},
+	    {"enter 0x20, 0", {0xC8, 0x20, 0x00, 0x00}, 4, 0, 1, 3},
+	    {"syscall", {0x0F, 0x05}, 2},
+	    {"mov [rsp+8], rbx", {0x48, 0x89, 0x5C, 0x24, 0x08}, 5, 4},
+	    {"lea r8, [rax+rcx]", {0x4C, 0x8D, 0x04, 0x08}, 4},
+	    {"mov eax, [0x1000]", {0x8B, 0x04, 0x25, 0x00, 0x10, 0x00, 0x00}, 7, 3},
+	    {"mov eax, [rsp+0x100]", {0x8B, 0x84, 0x24, 0x00, 0x01, 0x00, 0x00}, 7, 3},
+	    {"mov rax, gs:[0x60]", {0x65, 0x48, 0x8B, 0x04, 0x25, 0x60, 0x00, 0x00, 0x00}, 9, 5},
+
+	    // RIP-relative, with the immediate after the displacement.
+	    {"mov rax, [rip]", {0x48, 0x8B, 0x05, 0x11, 0x22, 0x33, 0x44}, 7, 3, 0, 0, true},
+	    {"lea rcx, [rip]", {0x48, 0x8D, 0x0D, 0x11, 0x22, 0x33, 0x44}, 7, 3, 0, 0, true},
+	    {"cmp byte [rip], 1", {0x80, 0x3D, 0x11, 0x22, 0x33, 0x44, 0x01}, 7, 2, 6, 1, true},
+	    {"test byte [rip], 1", {0xF6, 0x05, 0x11, 0x22, 0x33, 0x44, 0x01}, 7, 2, 6, 1, true},
+	    {"mov word [rip], 0x1234", {0x66, 0xC7, 0x05, 0x11, 0x22, 0x33, 0x44, 0x34, 0x12}, 9, 3, 7, 2, true},
+	    {"cmp qword [rip], imm32", {0x48, 0x81, 0x3D, 0x11, 0x22, 0x33, 0x44, 0x01, 0x02, 0x03, 0x04}, 11, 3, 7, 4, true},
+	    {"lock cmpxchg [rip], rcx", {0xF0, 0x48, 0x0F, 0xB1, 0x0D, 0x11, 0x22, 0x33, 0x44}, 9, 5, 0, 0, true},
+
+	    // Operand size prefix and REX.W on immediates.
+	    {"add cx, 0x1234", {0x66, 0x81, 0xC1, 0x34, 0x12}, 5, 0, 3, 2},
+	    {"mov rax, imm32", {0x48, 0xC7, 0xC0, 0x01, 0x02, 0x03, 0x04}, 7, 0, 3, 4},
+	    {"mov eax, imm32", {0xB8, 0x01, 0x02, 0x03, 0x04}, 5, 0, 1, 4},
+	    {"mov ax, imm16", {0x66, 0xB8, 0x01, 0x02}, 4, 0, 2, 2},
+	    {"mov r8d, imm32", {0x41, 0xB8, 0x01, 0x02, 0x03, 0x04}, 6, 0, 2, 4},
+	    {"mov rax, imm64", {0x48, 0xB8, 0x01, 0x02, 0x03, 0x04, 0x05, 0x06, 0x07, 0x08}, 10, 0, 2, 8},
+	    {"mov eax, [moffs64]", {0xA1, 0x01, 0x02, 0x03, 0x04, 0x05, 0x06, 0x07, 0x08}, 9, 0, 1, 8},
+	    {"mov eax, [moffs32]", {0x67, 0xA1, 0x01, 0x02, 0x03, 0x04}, 6, 0, 2, 4},
+	    {"neg eax", {0xF7, 0xD8}, 2},
+	    {"test ecx, imm32", {0xF7, 0xC1, 0x01, 0x02, 0x03, 0x04}, 6, 0, 2, 4},
+	    {"bt eax, 5", {0x0F, 0xBA, 0xE0, 0x05}, 4, 0, 3, 1},
+
+	    // Branches.
+	    {"call rel32", {0xE8, 0x01, 0x02, 0x03, 0x04}, 5, 0, 1, 4, false, true},
+	    {"jmp rel32", {0xE9, 0x01, 0x02, 0x03, 0x04}, 5, 0, 1, 4, false, true},
+	    {"jmp rel8", {0xEB, 0x10}, 2, 0, 1, 1, false, true},
+	    {"je rel8", {0x74, 0x05}, 2, 0, 1, 1, false, true},
+	    {"je rel32", {0x0F, 0x84, 0x01, 0x02, 0x03, 0x04}, 6, 0, 2, 4, false, true},
+	    {"call [rip]", {0xFF, 0x15, 0x11, 0x22, 0x33, 0x44}, 6, 2, 0, 0, true},
+
+	    // Multi byte nops.
+	    {"nop dword [rax+rax]", {0x0F, 0x1F, 0x44, 0x00, 0x00}, 5, 4},
+	    {"nop word [rax+rax+0]", {0x66, 0x0F, 0x1F, 0x84, 0x00, 0x00, 0x00, 0x00, 0x00}, 9, 5},
+
+	    // 0F 38 / 0F 3A maps, the latter always has an imm8.
+	    {"pshufb mm0, mm1", {0x0F, 0x38, 0x00, 0xC1}, 4},
+	    {"pshufb xmm0, [rip]", {0x66, 0x0F, 0x38, 0x00, 0x05, 0x11, 0x22, 0x33, 0x44}, 9, 5, 0, 0, true},
+	    {"palignr xmm0, xmm1, 8", {0x66, 0x0F, 0x3A, 0x0F, 0xC1, 0x08}, 6, 0, 5, 1},
+	    {"pextrd [rip], xmm0, 1", {0x66, 0x0F, 0x3A, 0x16, 0x05, 0x11, 0x22, 0x33, 0x44, 0x01}, 10, 5, 9, 1, true},
+
+	    // VEX.
+	    {"vzeroupper", {0xC5, 0xF8, 0x77}, 3},
+	    {"vmovaps ymm0, [rip]", {0xC5, 0xFC, 0x28, 0x05, 0x11, 0x22, 0x33, 0x44}, 8, 4, 0, 0, true},
+	    {"vshufps xmm0, xmm1, xmm2, 1", {0xC5, 0xF0, 0xC6, 0xC2, 0x01}, 5, 0, 4, 1},
+	    {"vbroadcastss ymm0, [rip]", {0xC4, 0xE2, 0x7D, 0x18, 0x05, 0x11, 0x22, 0x33, 0x44}, 9, 5, 0, 0, true},
+	    {"vinsertf128 ymm0, ymm0, xmm1, 1", {0xC4, 0xE3, 0x7D, 0x18, 0xC1, 0x01}, 6, 0, 5, 1},
+
+	    // EVEX, disp8 is scaled by the operand size but still a single byte.
+	    {"vmovaps zmm0, [rip]", {0x62, 0xF1, 0x7C, 0x48, 0x28, 0x05, 0x11, 0x22, 0x33, 0x44}, 10, 6, 0, 0, true},
+	    {"vmovaps zmm0, [rsp+0x40]", {0x62, 0xF1, 0x7C, 0x48, 0x28, 0x44, 0x24, 0x01}, 8, 7},
+	    {"vextractf32x4 xmm1, zmm0, 1", {0x62, 0xF3, 0x7D, 0x48, 0x19, 0xC1, 0x01}, 7, 0, 6, 1},
+	};
+
+	void test_corpus()
+	{
+		for (const auto& entry : corpus)
+		{
+			const std::vector<uint8_t> code(entry.m_bytes);
+			const auto instruction = x64::decode_length(code.data(), code.size());
+			if (!instruction)
+			{
+				std::fprintf(stderr, "%s: not decoded\n", entry.m_text);
+				CHECK(instruction);
+				continue;
+			}
+
+			const auto ok = instruction->m_length == entry.m_length && instruction->m_displacement_offset == entry.m_displacement_offset
+			             && instruction->m_immediate_offset == entry.m_immediate_offset && instruction->m_immediate_size == entry.m_immediate_size
+			             && instruction->m_rip_relative == entry.m_rip_relative && instruction->m_relative_immediate == entry.m_relative_immediate;
+			if (!ok)
+			{
+				std::fprintf(stderr, "%s: decoded as %u bytes\n", entry.m_text, instruction->m_length);
+			}
+			CHECK(ok);
+
+			// Never reads past the available bytes.
+			CHECK(!x64::decode_length(code.data(), code.size() - 1));
+		}
+	}
+
+	void test_invalid_and_truncated()
+	{
+		const uint8_t push_es[]  = {0x06};
+		const uint8_t ud0[]      = {0x0F, 0xFF, 0xC0};
+		const uint8_t rex_only[] = {0x48};
+		CHECK(!x64::decode_length(push_es, sizeof(push_es)));
+		CHECK(!x64::decode_length(ud0, sizeof(ud0)));
+		CHECK(!x64::decode_length(rex_only, sizeof(rex_only)));
+		CHECK(!x64::decode_length(nullptr, 0));
+
+		// 15 bytes at most, whatever is available.
+		std::vector<uint8_t> prefixes(16, 0x66);
+		prefixes.back() = 0x90;
+		CHECK(!x64::decode_length(prefixes.data(), prefixes.size()));
+		CHECK(x64::decode_length(prefixes.data() + 1, prefixes.size() - 1));
+	}
+
+	// tiny.dll (see data/make_tiny_pe.py) with its 0x20 byte .text rewritten: two instructions pairs only told apart by the following jcc.
+	const uint8_t text[] = {
+	    0x48, 0x8B, 0x05, 0x11, 0x22, 0x33, 0x44, // 0x00 mov rax, [rip]
+	    0x48, 0x85, 0xC0,                         // 0x07 test rax, rax
+	    0x74, 0x02,                               // 0x0A je
+	    0x48, 0x8B, 0x05, 0x55, 0x66, 0x77, 0x08, // 0x0C mov rax, [rip], another displacement
+	    0x48, 0x85, 0xC0,                         // 0x13 test rax, rax
+	    0x75, 0x02,                               // 0x16 jne
+	    0xC3,                                     // 0x18 ret
+	};
+
+	void test_make_signature()
+	{
+		const pe_image tiny(std::filesystem::path(TEST_DATA_DIR) / "tiny.dll");
+		CHECK(tiny.loaded());
+		if (!tiny.loaded())
+		{
+			return;
+		}
+
+		std::vector<uint8_t> image(tiny.base(), tiny.base() + tiny.size());
+		std::memcpy(image.data() + 0x10'00, text, sizeof(text));
+		const range image_range(handle(image.data()), image.size());
+		const range text_range(handle(image.data() + 0x10'00), 0x20);
+
+		const auto signature_at = [&](uint32_t offset, const signature_options& options = {})
+		{
+			return make_signature(image_range, handle(image.data() + 0x10'00 + offset), options);
+		};
+
+		// The displacements are wildcarded, the jcc makes them unique.
+		CHECK(signature_at(0x00) == "48 8B 05 ? ? ? ? 48 85 C0 74");
+		CHECK(signature_at(0x0C) == "48 8B 05 ? ? ? ? 48 85 C0 75");
+		CHECK(signature_at(0x07) == "48 85 C0 74 02");
+
+		// Every signature found matches its address and nothing else.
+		for (const uint32_t offset : {0x00, 0x07, 0x0A, 0x0C, 0x13, 0x16})
+		{
+			const auto signature = signature_at(offset);
+			CHECK(signature);
+			if (signature)
+			{
+				const auto matches = text_range.scan_all(pattern(*signature));
+				CHECK(matches.size() == 1 && matches.front().as<const uint8_t*>() == image.data() + 0x10'00 + offset);
+			}
+		}
+
+		// Too short to be unique, or outside of the scanned sections.
+		signature_options short_options;
+		short_options.m_max_length = 8;
+		CHECK(!signature_at(0x00, short_options));
+		CHECK(!make_signature(image_range, handle(image.data() + 0x20'00)));
+		CHECK(!make_signature(image_range, handle(image.data() + image.size())));
+	}
+} // namespace
+
+int main()
+{
+	test_corpus();
+	test_invalid_and_truncated();
+	test_make_signature();
+
+	return CHECK_RESULT();
+}
@@ -0,0 +1,160 @@
+#include "check.hpp"
+#include "memory/import_index.hpp"
+#include "memory/pe.hpp"
+#include "memory/pe_image.hpp"
+
+#include <cstring>
+#include <vector>
+
+using namespace memory;
+
+namespace
+{
+	// Generated by data/make_tiny_pe.py.
+	const auto tiny_dll_path = std::filesystem::path(TEST_DATA_DIR) / "tiny.dll";
+
+	void test_pe_image_layout()
+	{
+		const pe_image image(tiny_dll_path);
+		CHECK(image.loaded());
+		if (!image.loaded())
+		{
+			return;
+		}
+
+		CHECK(image.size() == 0x40'00);
+		CHECK(image.timestamp() == 0x5E'AD'BE'EF);
+
+		// Sections are copied at their rvas, not at their file offsets.
+		const uint8_t text_start[] = {0x48, 0x8B, 0x05, 0xF9, 0x0F, 0x00, 0x00};
+		CHECK(std::memcmp(image.base() + 0x10'00, text_start, sizeof(text_start)) == 0);
+
+		const uint64_t data_value = 0x11'22'33'44'55'66'77'88;
+		CHECK(std::memcmp(image.base() + 0x30'00, &data_value, sizeof(data_value)) == 0);
+	}
+
+	void test_read_sections()
+	{
+		const pe_image image(tiny_dll_path);
+		const auto& sections = image.sections();
+		CHECK(sections.size() == 3);
+		if (sections.size() != 3)
+		{
+			return;
+		}
+
+		CHECK(sections[0].m_name == ".text");
+		CHECK(sections[0].m_rva == 0x10'00);
+		CHECK(sections[0].m_size == 0x20);
+		CHECK(sections[0].m_type == section_type::executable);
+
+		CHECK(sections[1].m_name == ".rdata");
+		CHECK(sections[1].m_rva == 0x20'00);
+		CHECK(sections[1].m_type == section_type::read_only_data);
+
+		CHECK(sections[2].m_name == ".data");
+		CHECK(sections[2].m_rva == 0x30'00);
+		CHECK(sections[2].m_size == 0x80);
+		CHECK(sections[2].m_type == section_type::writable_data);
+
+		// Same result from the mapped image as from the pe_image.
+		const auto reparsed = pe::read_sections(image.base(), image.size());
+		CHECK(reparsed.size() == sections.size());
+	}
+
+	void test_read_imports()
+	{
+		const pe_image image(tiny_dll_path);
+		const auto imports = pe::read_imports(image.base(), image.size());
+		CHECK(imports.size() == 3);
+		if (imports.size() != 3)
+		{
+			return;
+		}
+
+		// Import directory order, slots are consecutive in the IAT of each DLL.
+		CHECK(imports[0].m_dll == "KERNEL32.dll");
+		CHECK(imports[0].m_name == "GetProcAddress");
+		CHECK(imports[0].m_slot_rva == 0x20'64);
+
+		CHECK(imports[1].m_dll == "KERNEL32.dll");
+		CHECK(imports[1].m_name == "LoadLibraryA");
+		CHECK(imports[1].m_slot_rva == 0x20'6C);
+
+		CHECK(imports[2].m_dll == "WS2_32.dll");
+		CHECK(imports[2].m_name.empty());
+		CHECK(imports[2].m_ordinal == 23);
+		CHECK(imports[2].m_slot_rva == 0x20'7C);
+
+		const import_index index(image.base(), image.size());
+		CHECK(index.find("kernel32.dll", "LoadLibraryA") == 0x20'6C);
+		CHECK(index.find("", "GetProcAddress") == 0x20'64);
+		CHECK(index.find("ws2_32.dll", uint16_t{23}) == 0x20'7C);
+		CHECK(!index.find("kernel32.dll", "FreeLibrary"));
+		CHECK(!index.find("user32.dll", "LoadLibraryA"));
+	}
+
+	void test_rejects_invalid_images()
+	{
+		const pe_image missing(std::filesystem::path(TEST_DATA_DIR) / "missing.dll");
+		CHECK(!missing.loaded());
+
+		std::vector<uint8_t> garbage(0x4'00, 0xCC);
+		CHECK(pe::read_nt_headers(garbage.data(), garbage.size()) == nullptr);
+		CHECK(pe::read_sections(garbage.data(), garbage.size()).empty());
+		CHECK(pe::read_imports(garbage.data(), garbage.size()).empty());
+
+		// Valid headers cut short.
+		const pe_image image(tiny_dll_path);
+		CHECK(pe::read_nt_headers(image.base(), 0x80) == nullptr);
+		CHECK(pe::read_nt_headers(image.base(), image.size()) != nullptr);
+	}
+
+	void put(std::vector<uint8_t>& image, uint32_t rva, const void* data, std::size_t size)
+	{
+		std::memcpy(image.data() + rva, data, size);
+	}
+
+	void test_primary_runtime_function()
+	{
+		// A primary fragment, a fragment chained to it, and an indirect entry sharing the chained fragment's unwind info.
+		const pe::runtime_function functions[] = {
+		    {0x1'00, 0x1'10, 0x1'80},
+		    {0x1'20, 0x1'30, 0x1'90},
+		    {0x1'40, 0x1'50, 0x1'A0 | 1},
+		    {0x1'60, 0x1'70, 0x1'F8 | 1},
+		};
+
+		std::vector<uint8_t> image(0x2'00);
+		const uint8_t primary_info[] = {0x01, 0x00, 0x00, 0x00};
+		// Version 1, UNW_FLAG_CHAININFO, no unwind codes: the parent RUNTIME_FUNCTION follows right away.
+		const uint8_t chained_info[] = {0x01 | (0x04 << 3), 0x00, 0x00, 0x00};
+		put(image, 0x1'80, primary_info, sizeof(primary_info));
+		put(image, 0x1'90, chained_info, sizeof(chained_info));
+		put(image, 0x1'94, &functions[0], sizeof(pe::runtime_function));
+		put(image, 0x1'A0, &functions[1], sizeof(pe::runtime_function));
+
+		const auto primary = [&](const pe::runtime_function& entry)
+		{
+			return pe::primary_runtime_function(image.data(), image.size(), functions, &entry);
+		};
+
+		CHECK(primary(functions[0]) == &functions[0]);
+		CHECK(primary(functions[1]) == &functions[0]);
+		CHECK(primary(functions[2]) == &functions[0]);
+		// Indirection out of the image, the entry itself is the best there is.
+		CHECK(primary(functions[3]) == &functions[3]);
+		CHECK(!pe::primary_runtime_function(image.data(), image.size(), functions, nullptr));
+	}
+} // namespace
+
+int main()
+{
+	test_pe_image_layout();
+	test_read_sections();
+	test_read_imports();
+	test_rejects_invalid_images();
+	test_primary_runtime_function();
+
+	return CHECK_RESULT();
+}
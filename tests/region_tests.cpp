@@ -0,0 +1,143 @@
+#include "check.hpp"
+#include "memory/pattern.hpp"
+#include "memory/region.hpp"
+#include "threads/thread_pool.hpp"
+
+#include <algorithm>
+#include <random>
+#include <string>
+#include <vector>
+
+using namespace memory;
+
+namespace
+{
+	void probe()
+	{
+	}
+
+	bool contains(const std::vector<region>& regions, const void* address)
+	{
+		const auto value = reinterpret_cast<uintptr_t>(address);
+		return std::any_of(regions.begin(),
+		                   regions.end(),
+		                   [value](const region& region)
+		                   {
+			                   return value >= region.m_base && value < region.m_base + region.m_size;
+		                   });
+	}
+
+	const region* find(const std::vector<region>& regions, const void* address)
+	{
+		const auto value = reinterpret_cast<uintptr_t>(address);
+		for (const auto& region : regions)
+		{
+			if (value >= region.m_base && value < region.m_base + region.m_size)
+			{
+				return &region;
+			}
+		}
+
+		return nullptr;
+	}
+
+	void test_enumerate_regions()
+	{
+		// Big enough to get its own anonymous mapping.
+		std::vector<uint8_t> heap(0x20'00'00, 1);
+		int stack = 0;
+
+		const auto regions = enumerate_regions();
+		CHECK(!regions.empty());
+		for (std::size_t i = 0; i < regions.size(); i++)
+		{
+			CHECK(regions[i].m_size);
+			CHECK(has_region_protection(regions[i].m_protection, region_protection::read));
+			if (i)
+			{
+				CHECK(regions[i - 1].m_base + regions[i - 1].m_size <= regions[i].m_base);
+			}
+		}
+
+		const auto heap_region = find(regions, heap.data());
+		CHECK(heap_region && !heap_region->m_image && has_region_protection(heap_region->m_protection, region_protection::read | region_protection::write));
+
+		const auto stack_region = find(regions, &stack);
+		CHECK(stack_region && !stack_region->m_image && has_region_protection(stack_region->m_protection, region_protection::write));
+
+		const auto code_region = find(regions, reinterpret_cast<const void*>(&probe));
+		CHECK(code_region && code_region->m_image && has_region_protection(code_region->m_protection, region_protection::execute));
+	}
+
+	void test_enumerate_regions_filter()
+	{
+		std::vector<uint8_t> heap(0x20'00'00, 1);
+		const auto code = reinterpret_cast<const void*>(&probe);
+
+		const auto executable = enumerate_regions({.m_required = region_protection::read | region_protection::execute});
+		CHECK(contains(executable, code));
+		CHECK(!contains(executable, heap.data()));
+		for (const auto& region : executable)
+		{
+			CHECK(has_region_protection(region.m_protection, region_protection::execute));
+		}
+
+		const auto private_memory = enumerate_regions({.m_include_images = false});
+		CHECK(contains(private_memory, heap.data()));
+		CHECK(!contains(private_memory, code));
+
+		const auto read_only = enumerate_regions({.m_excluded = region_protection::write});
+		CHECK(!contains(read_only, heap.data()));
+	}
+
+	void test_scan_regions()
+	{
+		std::mt19937 rng(4321);
+
+		std::vector<uint8_t> marker(24);
+		std::string ida;
+		for (auto& byte : marker)
+		{
+			byte = static_cast<uint8_t>(rng());
+			char hex[4];
+			std::snprintf(hex, sizeof(hex), "%02X ", byte);
+			ida += hex;
+		}
+
+		// Twice in a buffer spanning several chunks, the compiled pattern itself can match as well.
+		std::vector<uint8_t> heap(0x90'00'00, 0);
+		std::copy(marker.begin(), marker.end(), heap.begin() + 0x10);
+		std::copy(marker.begin(), marker.end(), heap.end() - marker.size());
+		const pattern pat(ida);
+
+		big::thread_pool* pool = nullptr;
+		for (int run = 0; run < 2; run++)
+		{
+			if (run == 1)
+			{
+				pool = new big::thread_pool(4);
+			}
+
+			std::vector<handle> found;
+			scan_regions(pat.view(), found, {.m_include_images = false});
+			CHECK(std::is_sorted(found.begin(), found.end(), [](handle a, handle b) { return a.as<uintptr_t>() < b.as<uintptr_t>(); }));
+			CHECK(std::find(found.begin(), found.end(), handle(heap.data() + 0x10)) != found.end());
+			CHECK(std::find(found.begin(), found.end(), handle(heap.data() + heap.size() - marker.size())) != found.end());
+
+			scan_regions(pat.view(), found, {.m_include_images = false}, 1);
+			CHECK(found.size() == 1);
+		}
+
+		pool->destroy();
+		delete pool;
+	}
+} // namespace
+
+int main()
+{
+	test_enumerate_regions();
+	test_enumerate_regions_filter();
+	test_scan_regions();
+
+	return CHECK_RESULT();
+}
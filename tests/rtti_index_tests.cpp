@@ -0,0 +1,190 @@
+#include "check.hpp"
+#include "memory/module_cache_file.hpp"
+#include "memory/rtti_index.hpp"
+
+#include <algorithm>
+#include <cstring>
+#include <filesystem>
+#include <string_view>
+#include <vector>
+
+using namespace memory;
+
+namespace
+{
+	constexpr uint64_t image_base    = 0x1'80'00'00'00;
+	constexpr uint32_t rdata_rva     = 0x10'00;
+	constexpr uint32_t image_size    = 0x20'00;
+	constexpr uint32_t foo_type_rva  = rdata_rva + 0x1'00;
+	constexpr uint32_t bar_type_rva  = rdata_rva + 0x1'40;
+	constexpr uint32_t foo_vtable    = rdata_rva + 0x3'08;
+	constexpr uint32_t foo_vtable_8  = rdata_rva + 0x3'48;
+	constexpr uint32_t bar_vtable    = rdata_rva + 0x3'88;
+	constexpr uint32_t timestamp     = 0x5E'AD'BE'EF;
+	constexpr uint64_t cache_version = 1;
+
+	const auto cache_folder = std::filesystem::temp_directory_path() / "rom_rtti_index_tests";
+
+	// Hand built MSVC x64 RTTI: type descriptors, complete object locators, and vtables preceded by a pointer to their locator.
+	class test_image
+	{
+	public:
+		test_image() :
+		    m_bytes(image_size, 0)
+		{
+			put_type_descriptor(foo_type_rva, ".?AVFoo@ns@@");
+			put_type_descriptor(bar_type_rva, ".?AUBar@@");
+
+			put_locator(rdata_rva + 0x2'00, foo_type_rva, 0, rdata_rva + 0x2'00);
+			put_locator(rdata_rva + 0x2'20, foo_type_rva, 8, rdata_rva + 0x2'20);
+			put_locator(rdata_rva + 0x2'40, bar_type_rva, 0, rdata_rva + 0x2'40);
+			// Self rva not pointing back at it: not a locator.
+			put_locator(rdata_rva + 0x2'60, bar_type_rva, 0, rdata_rva + 0x2'00);
+
+			put_pointer(foo_vtable - 8, rdata_rva + 0x2'00);
+			put_pointer(foo_vtable_8 - 8, rdata_rva + 0x2'20);
+			put_pointer(bar_vtable - 8, rdata_rva + 0x2'40);
+			put_pointer(rdata_rva + 0x3'C0, rdata_rva + 0x2'60);
+		}
+
+		void put_locator(uint32_t rva, uint32_t type_descriptor_rva, uint32_t offset, uint32_t self_rva)
+		{
+			const uint32_t locator[] = {1, offset, 0, type_descriptor_rva, 0, self_rva};
+			std::memcpy(m_bytes.data() + rva, locator, sizeof(locator));
+		}
+
+		uint8_t* data()
+		{
+			return m_bytes.data();
+		}
+
+	private:
+		void put_type_descriptor(uint32_t rva, std::string_view name)
+		{
+			// type_info vtable and spare pointers first, the name is NUL terminated by the zero filled image.
+			std::memcpy(m_bytes.data() + rva + 16, name.data(), name.size());
+		}
+
+		void put_pointer(uint32_t rva, uint32_t target_rva)
+		{
+			const uint64_t pointer = image_base + target_rva;
+			std::memcpy(m_bytes.data() + rva, &pointer, sizeof(pointer));
+		}
+
+		std::vector<uint8_t> m_bytes;
+	};
+
+	const std::vector<pe::section_info> sections = {
+	    {".text", 0, rdata_rva, section_type::executable},
+	    {".rdata", rdata_rva, image_size - rdata_rva, section_type::read_only_data},
+	};
+
+	bool finds(const rtti_index& index, test_image& image, std::string_view name, uint32_t offset, uint32_t vtable_rva)
+	{
+		const auto vtable = index.find_vtable(name, offset);
+		return vtable && vtable->as<uint8_t*>() == image.data() + vtable_rva;
+	}
+
+	void test_mangle_type_name()
+	{
+		CHECK(rtti_index::mangle_type_name("class ns::Foo") == ".?AVFoo@ns@@");
+		CHECK(rtti_index::mangle_type_name("struct Bar") == ".?AUBar@@");
+		CHECK(rtti_index::mangle_type_name("union a::b::U") == ".?ATU@b@a@@");
+		CHECK(rtti_index::mangle_type_name("Baz") == ".?AVBaz@@");
+		CHECK(rtti_index::mangle_type_name(".?AVFoo@@") == ".?AVFoo@@");
+		CHECK(rtti_index::mangle_type_name("class Foo<int>") == "class Foo<int>");
+	}
+
+	void test_find_vtable()
+	{
+		test_image image;
+		const rtti_index index(image.data(), image_size, image_base, sections);
+		CHECK(index.vtables().size() == 3);
+
+		CHECK(finds(index, image, "class ns::Foo", 0, foo_vtable));
+		CHECK(finds(index, image, "class ns::Foo", 8, foo_vtable_8));
+		CHECK(finds(index, image, "struct Bar", 0, bar_vtable));
+		CHECK(finds(index, image, ".?AUBar@@", 0, bar_vtable));
+
+		CHECK(!index.find_vtable("class ns::Foo", 16));
+		CHECK(!index.find_vtable("class Bar"));
+		CHECK(!index.find_vtable("class Foo"));
+	}
+
+	void test_cache_round_trip()
+	{
+		test_image image;
+		const rtti_index index(image.data(), image_size, image_base, sections);
+		std::filesystem::remove_all(cache_folder);
+
+		const auto file_version = module_file_version(timestamp, image_size);
+		module_cache_file<rtti_vtable>(cache_folder, "fixture.dll", file_version, "rtti", cache_version).write(index.vtables());
+
+		auto vtables = module_cache_file<rtti_vtable>(cache_folder, "fixture.dll", file_version, "rtti", cache_version).load();
+		CHECK(vtables && vtables->size() == index.vtables().size());
+		if (!vtables)
+		{
+			return;
+		}
+
+		CHECK(std::ranges::equal(*vtables,
+		                         index.vtables(),
+		                         [](const rtti_vtable& a, const rtti_vtable& b)
+		                         {
+			                         return a.m_vtable_rva == b.m_vtable_rva && a.m_type_descriptor_rva == b.m_type_descriptor_rva && a.m_offset == b.m_offset;
+		                         }));
+		CHECK(rtti_index::is_valid(image.data(), image_size, image_base, *vtables));
+
+		const rtti_index restored(image.data(), std::move(*vtables));
+		CHECK(finds(restored, image, "class ns::Foo", 8, foo_vtable_8));
+		CHECK(finds(restored, image, "struct Bar", 0, bar_vtable));
+	}
+
+	void test_cache_invalidation()
+	{
+		test_image image;
+		const rtti_index index(image.data(), image_size, image_base, sections);
+		std::filesystem::remove_all(cache_folder);
+
+		const auto file_version = module_file_version(timestamp, image_size);
+		module_cache_file<rtti_vtable>(cache_folder, "fixture.dll", file_version, "rtti", cache_version).write(index.vtables());
+
+		// Another build of the module, or another record layout.
+		CHECK(!module_cache_file<rtti_vtable>(cache_folder, "fixture.dll", module_file_version(timestamp + 1, image_size), "rtti", cache_version).load());
+		CHECK(!module_cache_file<rtti_vtable>(cache_folder, "fixture.dll", file_version, "rtti", cache_version + 1).load());
+		// No folder, nothing is read.
+		CHECK(!module_cache_file<rtti_vtable>({}, "fixture.dll", file_version, "rtti", cache_version).load());
+
+		// Records which don't describe the image anymore.
+		const auto& vtables = index.vtables();
+		CHECK(rtti_index::is_valid(image.data(), image_size, image_base, vtables));
+
+		auto out_of_image            = vtables;
+		out_of_image[0].m_vtable_rva = image_size;
+		CHECK(!rtti_index::is_valid(image.data(), image_size, image_base, out_of_image));
+
+		auto other_offset        = vtables;
+		other_offset[0].m_offset = 4;
+		CHECK(!rtti_index::is_valid(image.data(), image_size, image_base, other_offset));
+
+		auto reversed = vtables;
+		std::ranges::reverse(reversed);
+		CHECK(!rtti_index::is_valid(image.data(), image_size, image_base, reversed));
+
+		// Same records, but the locator of Foo moved away.
+		image.put_locator(rdata_rva + 0x2'00, foo_type_rva, 0, rdata_rva + 0x2'04);
+		CHECK(!rtti_index::is_valid(image.data(), image_size, image_base, vtables));
+
+		std::filesystem::remove_all(cache_folder);
+	}
+} // namespace
+
+int main()
+{
+	test_mangle_type_name();
+	test_find_vtable();
+	test_cache_round_trip();
+	test_cache_invalidation();
+
+	return CHECK_RESULT();
+}
@@ -0,0 +1,296 @@
+#include "check.hpp"
+#include "memory/multi_pattern.hpp"
+#include "memory/pattern.hpp"
+#include "memory/range.hpp"
+#include "memory/scanner.hpp"
+#include "memory/signature.hpp"
+#include "memory/signature_hasher.hpp"
+#include "memory/static_pattern.hpp"
+#include "threads/thread_pool.hpp"
+
+#include <algorithm>
+#include <random>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace memory;
+
+namespace
+{
+	std::vector<std::size_t> reference_find_all(const std::vector<uint8_t>& data, const scanner::pattern_view& sig)
+	{
+		std::vector<std::size_t> result;
+		for (std::size_t i = 0; i + sig.m_size <= data.size(); i++)
+		{
+			if (scanner::matches(data.data() + i, sig))
+			{
+				result.push_back(i);
+			}
+		}
+
+		return result;
+	}
+
+	// Patterns are cut from the data itself so most of them match, with random wildcards.
+	std::string random_pattern(const std::vector<uint8_t>& data, std::mt19937& rng)
+	{
+		const auto size   = std::uniform_int_distribution<std::size_t>(1, 40)(rng);
+		const auto offset = std::uniform_int_distribution<std::size_t>(0, data.size() - size)(rng);
+
+		std::string ida;
+		for (std::size_t i = 0; i < size; i++)
+		{
+			char byte[4];
+			std::snprintf(byte, sizeof(byte), "%02X ", data[offset + i]);
+			ida += rng() % 4 == 0 ? "? " : byte;
+		}
+
+		return ida;
+	}
+
+	void test_kernels_match_reference()
+	{
+		std::mt19937 rng(1234);
+
+		// Small alphabet so partial matches and anchor hits are frequent.
+		std::vector<uint8_t> data(64 * 1024 + 13);
+		for (auto& byte : data)
+		{
+			byte = static_cast<uint8_t>(rng() % 6 == 0 ? rng() : rng() % 4);
+		}
+
+		for (int i = 0; i < 200; i++)
+		{
+			const pattern pat(random_pattern(data, rng));
+			const auto sig      = pat.view();
+			const auto expected = reference_find_all(data, sig);
+
+			for (const auto kernel : {scanner::isa::scalar, scanner::isa::sse2, scanner::isa::avx2})
+			{
+				std::vector<std::size_t> found;
+				scanner::find_all(data.data(), data.size(), sig, found, kernel);
+				CHECK(found == expected);
+
+				const auto first = scanner::find_first(data.data(), data.size(), sig, kernel);
+				CHECK(first == (expected.empty() ? scanner::npos : expected.front()));
+			}
+		}
+	}
+
+	void test_match_at_buffer_edges()
+	{
+		std::vector<uint8_t> data(100, 0x90);
+		data[0]  = 0xE8;
+		data[1]  = 0x12;
+		data[98] = 0xE8;
+		data[99] = 0x12;
+
+		const pattern pat("E8 12");
+		for (const auto kernel : {scanner::isa::scalar, scanner::isa::sse2, scanner::isa::avx2})
+		{
+			// Every size, so the vector loops and the scalar tails are both covered.
+			for (std::size_t size = 0; size <= data.size(); size++)
+			{
+				std::vector<std::size_t> found;
+				scanner::find_all(data.data(), size, pat.view(), found, kernel);
+
+				std::vector<std::size_t> expected;
+				if (size >= 2)
+				{
+					expected.push_back(0);
+				}
+				if (size == 100)
+				{
+					expected.push_back(98);
+				}
+				CHECK(found == expected);
+			}
+		}
+	}
+
+	void test_wildcard_only_pattern()
+	{
+		const std::vector<uint8_t> data(10, 0xCC);
+		const pattern pat("? ? ?");
+
+		for (const auto kernel : {scanner::isa::scalar, scanner::isa::sse2, scanner::isa::avx2})
+		{
+			std::vector<std::size_t> found;
+			scanner::find_all(data.data(), data.size(), pat.view(), found, kernel);
+			CHECK(found.size() == 8);
+		}
+	}
+
+	void test_range_scan_all_reuses_output()
+	{
+		std::vector<uint8_t> data(0x10'00'00, 0x90);
+		for (std::size_t i = 7; i < data.size(); i += 0x1'00'01)
+		{
+			data[i] = 0xE8;
+		}
+
+		const pattern pat("90 E8 90");
+		const auto expected = reference_find_all(data, pat.view());
+
+		const range region(handle(data.data()), data.size());
+		std::vector<handle> found;
+
+		// Single chunk without a pool, then split in chunks on the pool with the same output vector.
+		big::thread_pool* pool = nullptr;
+		for (int run = 0; run < 3; run++)
+		{
+			if (run == 1)
+			{
+				pool = new big::thread_pool(4);
+			}
+
+			region.scan_all(pat, found);
+			CHECK(found.size() == expected.size());
+			for (std::size_t i = 0; i < found.size() && i < expected.size(); i++)
+			{
+				CHECK(found[i].as<const uint8_t*>() == data.data() + expected[i]);
+			}
+		}
+
+		pool->destroy();
+		delete pool;
+	}
+
+	void test_range_scan_parallel_matches_serial()
+	{
+		std::mt19937 rng(7);
+
+		std::vector<uint8_t> data(0x80'00'00);
+		for (auto& byte : data)
+		{
+			byte = static_cast<uint8_t>(rng());
+		}
+
+		const pattern pat("DE AD ? EF CA FE BA BE");
+		const auto marker = [&](std::size_t offset)
+		{
+			const uint8_t bytes[] = {0xDE, 0xAD, 0x00, 0xEF, 0xCA, 0xFE, 0xBA, 0xBE};
+			std::copy(std::begin(bytes), std::end(bytes), data.begin() + offset);
+		};
+
+		// Same chunking as range::scan_parallel, the first match straddles the end of the first chunk.
+		const auto candidate_count = data.size() - pat.view().m_size + 1;
+		const auto thread_count    = std::max(1u, std::thread::hardware_concurrency());
+		const auto chunk_size      = std::max<std::size_t>(0x4'00'00, candidate_count / (thread_count * 4) + 1);
+		marker(chunk_size - 3);
+		marker(chunk_size * 2 + 5);
+		marker(data.size() - 8);
+
+		big::thread_pool pool(4);
+		const range region(handle(data.data()), data.size());
+
+		std::vector<handle> serial;
+		region.scan_all(pat, serial);
+		CHECK(serial.size() >= 3);
+
+		const auto parallel = region.scan_parallel(pat);
+		CHECK(parallel && !serial.empty() && *parallel == serial.front());
+		CHECK(parallel && parallel->as<const uint8_t*>() == data.data() + chunk_size - 3);
+
+		// Only in the last chunk, then nowhere.
+		data[chunk_size - 3]     = 0;
+		data[chunk_size * 2 + 5] = 0;
+		const auto last          = region.scan_parallel(pat);
+		CHECK(last && last->as<const uint8_t*>() == data.data() + data.size() - 8);
+
+		data[data.size() - 8] = 0;
+		region.scan_all(pat, serial);
+		CHECK(region.scan_parallel(pat).has_value() == !serial.empty());
+
+		pool.destroy();
+	}
+
+	template<fixed_string ida_sig>
+	void check_static_pattern()
+	{
+		const pattern runtime(ida_sig.view());
+		const auto expected = runtime.view();
+		const auto actual   = static_pattern<ida_sig>::view();
+
+		CHECK(actual.m_size == expected.m_size);
+		CHECK(std::equal(actual.m_values, actual.m_values + actual.m_size, expected.m_values, expected.m_values + expected.m_size));
+		CHECK(std::equal(actual.m_masks, actual.m_masks + actual.m_size, expected.m_masks, expected.m_masks + expected.m_size));
+		CHECK(actual.m_anchor == expected.m_anchor);
+		CHECK(actual.m_anchor2 == expected.m_anchor2);
+		CHECK(actual.m_has_anchor == expected.m_has_anchor);
+	}
+
+	void on_found(handle)
+	{
+	}
+
+	// make_batch takes its signatures as template arguments, the static ones must stay usable there.
+	constexpr char batch_entry_name[] = "name";
+	static_assert(signature_hasher::add<static_signature<"48 8D 0D ? ? ? ? E8">(batch_entry_name, nullptr)>() == signature_hasher::fnv1a_32("48 8D 0D ? ? ? ? E8"));
+
+	// Baked at compile time, so it must agree with the runtime parser the scanners were tested with.
+	void test_static_pattern_matches_runtime_pattern()
+	{
+		check_static_pattern<"48 8B 05 ? ? ? ? 48 85 C0">();
+		check_static_pattern<"E8 ?? ?? ?? ?? 90">();
+		check_static_pattern<"CC">();
+		check_static_pattern<"? ? FF ? 00 00 00 ?">();
+		check_static_pattern<"? ??">();
+		check_static_pattern<"0f 1f 44 00 00">();
+
+		constexpr auto sig = static_signature<"48 8D 0D ? ? ? ? E8">("name", &on_found);
+		static_assert(sig.m_pattern.m_size == 8);
+		CHECK(sig.m_pattern.m_values == static_pattern<"48 8D 0D ? ? ? ? E8">::view().m_values);
+		CHECK(std::string_view(sig.m_ida) == "48 8D 0D ? ? ? ? E8");
+	}
+
+	void test_range_scan_first_matches_single_scans()
+	{
+		std::mt19937 rng(99);
+
+		// Large enough to be split in several chunks.
+		std::vector<uint8_t> data(0x40'00'00);
+		for (auto& byte : data)
+		{
+			byte = static_cast<uint8_t>(rng());
+		}
+
+		std::vector<pattern> patterns;
+		std::vector<scanner::pattern_view> views;
+		for (int i = 0; i < 64; i++)
+		{
+			patterns.emplace_back(random_pattern(data, rng));
+		}
+		patterns.emplace_back("DE AD BE EF DE AD BE EF DE AD BE EF");
+		for (const auto& pat : patterns)
+		{
+			views.push_back(pat.view());
+		}
+
+		const scanner::multi_pattern matcher(views);
+		const range region(handle(data.data()), data.size());
+		for (const auto thread_count : {1, 8})
+		{
+			const auto offsets = region.scan_first(matcher, thread_count);
+			CHECK(offsets.size() == patterns.size());
+			for (std::size_t i = 0; i < offsets.size() && i < patterns.size(); i++)
+			{
+				CHECK(offsets[i] == scanner::find_first(data.data(), data.size(), views[i]));
+			}
+		}
+	}
+} // namespace
+
+int main()
+{
+	test_kernels_match_reference();
+	test_match_at_buffer_edges();
+	test_wildcard_only_pattern();
+	test_range_scan_all_reuses_output();
+	test_range_scan_parallel_matches_serial();
+	test_static_pattern_matches_runtime_pattern();
+	test_range_scan_first_matches_single_scans();
+
+	return CHECK_RESULT();
+}
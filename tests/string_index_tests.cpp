@@ -0,0 +1,69 @@
+#include "check.hpp"
+#include "memory/string_index.hpp"
+
+#include <cstring>
+#include <string_view>
+#include <vector>
+
+using namespace memory;
+
+namespace
+{
+	constexpr uint32_t rdata_rva = 0x10'00;
+	constexpr uint32_t data_rva  = 0x20'00;
+
+	void put_narrow(std::vector<uint8_t>& image, uint32_t rva, std::string_view str)
+	{
+		std::memcpy(image.data() + rva, str.data(), str.size());
+		image[rva + str.size()] = 0;
+	}
+
+	void put_wide(std::vector<uint8_t>& image, uint32_t rva, std::string_view str)
+	{
+		for (std::size_t i = 0; i < str.size(); i++)
+		{
+			image[rva + i * 2]     = static_cast<uint8_t>(str[i]);
+			image[rva + i * 2 + 1] = 0;
+		}
+		image[rva + str.size() * 2]     = 0;
+		image[rva + str.size() * 2 + 1] = 0;
+	}
+
+	void test_string_index()
+	{
+		// Non printable filler, so only the planted strings are runs.
+		std::vector<uint8_t> image(0x30'00, 0xFF);
+		put_narrow(image, rdata_rva + 0x10, "Hello world");
+		put_narrow(image, rdata_rva + 0x40, "Say Hello world");
+		put_narrow(image, rdata_rva + 0x60, "Hello world");
+		put_wide(image, rdata_rva + 0x80, "Hello world");
+		put_narrow(image, rdata_rva + 0xC0, "abc");
+		put_narrow(image, data_rva + 0x10, "Writable string");
+		// Runs the end of the section without a terminator.
+		std::memcpy(image.data() + rdata_rva + 0xFC, "Tail", 4);
+
+		const std::vector<pe::section_info> sections = {
+		    {".rdata", rdata_rva, 0x1'00, section_type::read_only_data},
+		    {".data", data_rva, 0x1'00, section_type::writable_data},
+		};
+		const string_index index(image.data(), sections);
+		CHECK(index.size() == 4);
+
+		// Narrow and UTF-16 literals, sorted, substrings of longer literals excluded.
+		CHECK(index.find("Hello world") == std::vector<uint32_t>({rdata_rva + 0x10, rdata_rva + 0x60, rdata_rva + 0x80}));
+		CHECK(index.find("Say Hello world") == std::vector<uint32_t>({rdata_rva + 0x40}));
+
+		CHECK(index.find("Hello").empty());
+		CHECK(index.find("Hello world!").empty());
+		CHECK(index.find("abc").empty());
+		CHECK(index.find("Writable string").empty());
+		CHECK(index.find("Tail").empty());
+	}
+} // namespace
+
+int main()
+{
+	test_string_index();
+
+	return CHECK_RESULT();
+}
@@ -0,0 +1,7 @@
+#pragma once
+#include "logger/logger.hpp"
+
+// Stands in for the AsyncLogger package in the portable tests.
+namespace al
+{
+}
@@ -0,0 +1,5 @@
+#pragma once
+#include <iostream>
+
+// Stands in for src/logger/logger.hpp (AsyncLogger + Windows console) in the portable tests.
+#define LOG(level) std::clog << "[" #level "] "
@@ -0,0 +1,91 @@
+#include "check.hpp"
+#include "threads/thread_registry.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <latch>
+#include <thread>
+#include <unistd.h>
+#include <vector>
+
+using namespace big::threads;
+
+namespace
+{
+	std::vector<thread_id> registered_ids(thread_registry& registry)
+	{
+		std::vector<thread_id> ids;
+		registry.for_each(
+		    [&](registered_thread& thread)
+		    {
+			    ids.push_back(thread.m_id);
+		    });
+		return ids;
+	}
+
+	void test_refresh_tracks_threads()
+	{
+		thread_registry registry;
+		registry.refresh();
+
+		auto ids = registered_ids(registry);
+		CHECK(std::ranges::is_sorted(ids));
+		CHECK(std::ranges::find(ids, gettid()) != ids.end());
+		const auto initial_size = registry.size();
+
+		// Marking a thread suspended must survive the next refresh, known threads keep their entry.
+		registry.for_each(
+		    [](registered_thread& thread)
+		    {
+			    thread.m_suspended = thread.m_id == gettid();
+		    });
+
+		std::atomic<thread_id> worker_id{};
+		std::latch started(1);
+		std::latch stop(1);
+		std::thread worker(
+		    [&]
+		    {
+			    worker_id = gettid();
+			    started.count_down();
+			    stop.wait();
+		    });
+		started.wait();
+
+		registry.refresh();
+		ids = registered_ids(registry);
+		CHECK(registry.size() == initial_size + 1);
+		CHECK(std::ranges::is_sorted(ids));
+		CHECK(std::ranges::find(ids, worker_id.load()) != ids.end());
+		registry.for_each(
+		    [](registered_thread& thread)
+		    {
+			    CHECK(thread.m_suspended == (thread.m_id == gettid()));
+		    });
+
+		stop.count_down();
+		worker.join();
+
+		// join returns once the thread cleared its tid, the kernel may list the task a little longer.
+		for (int i = 0; i < 100; i++)
+		{
+			registry.refresh();
+			ids = registered_ids(registry);
+			if (std::ranges::find(ids, worker_id.load()) == ids.end())
+			{
+				break;
+			}
+			std::this_thread::sleep_for(std::chrono::milliseconds(1));
+		}
+		CHECK(registry.size() == initial_size);
+		CHECK(std::ranges::find(ids, worker_id.load()) == ids.end());
+	}
+} // namespace
+
+int main()
+{
+	test_refresh_tracks_threads();
+
+	return CHECK_RESULT();
+}
@@ -0,0 +1,92 @@
+#include "check.hpp"
+#include "memory/value_scanner.hpp"
+#include "threads/thread_pool.hpp"
+
+#include <algorithm>
+#include <cstring>
+#include <vector>
+
+using namespace memory;
+
+namespace
+{
+	template<typename T>
+	void plant(std::vector<uint8_t>& buffer, std::size_t offset, T value)
+	{
+		std::memcpy(buffer.data() + offset, &value, sizeof(T));
+	}
+
+	bool has_candidate(const value_scanner& scanner, const void* address)
+	{
+		const auto candidates = scanner.candidates(scanner.count());
+		return std::ranges::binary_search(candidates, reinterpret_cast<uintptr_t>(address));
+	}
+
+	// Above 2^53, a double would also match the neighbouring values.
+	void test_exact_u64_finds_only_the_planted_value()
+	{
+		std::vector<uint8_t> heap(0x10'00'00);
+		plant(heap, 0x1'00, 0xDE'AD'BE'EF'CA'FE'F0'0Dull);
+		plant(heap, 0x2'00, 0xDE'AD'BE'EF'CA'FE'F0'0Cull);
+
+		value_scanner scanner(value_type::u64);
+		value_condition condition;
+		condition.m_value = uint64_t{0xDE'AD'BE'EF'CA'FE'F0'0Dull};
+
+		// The scanner's own copies of the value, on the stacks and in its buffers, are not candidates.
+		CHECK(scanner.first_scan(condition) == 1);
+		CHECK(has_candidate(scanner, heap.data() + 0x1'00));
+
+		plant(heap, 0x1'00, 0xDE'AD'BE'EF'CA'FE'F0'0Eull);
+		condition.m_compare = value_compare::increased;
+		CHECK(scanner.next_scan(condition) == 1);
+		CHECK(has_candidate(scanner, heap.data() + 0x1'00));
+	}
+
+	void test_signed_range()
+	{
+		std::vector<uint8_t> heap(0x10'00'00);
+		plant(heap, 0x40, int32_t{-1'234'567'891});
+
+		value_scanner scanner(value_type::i32);
+		value_condition condition;
+		condition.m_compare = value_compare::range;
+		condition.m_value   = int64_t{-1'234'567'892};
+		condition.m_max     = -1'234'567'890.0;
+
+		CHECK(scanner.first_scan(condition) >= 1);
+		CHECK(has_candidate(scanner, heap.data() + 0x40));
+	}
+
+	// Out of range doubles are saturated to 64 bits then wrapped, 300 is 44 as a u8.
+	void test_out_of_range_double()
+	{
+		std::vector<uint8_t> heap(0x10'00'00, 0xA5);
+		heap[0x33] = 44;
+
+		value_scanner scanner(value_type::u8);
+		value_condition condition;
+		condition.m_value = 300.0;
+		CHECK(scanner.first_scan(condition) >= 1);
+		CHECK(has_candidate(scanner, heap.data() + 0x33));
+
+		value_scanner saturated(value_type::u16);
+		condition.m_value = 1e30;
+		saturated.first_scan(condition);
+	}
+} // namespace
+
+int main()
+{
+	test_exact_u64_finds_only_the_planted_value();
+	test_signed_range();
+	test_out_of_range_double();
+
+	// Again with the chunks scanned on the pool, whose workers have their own stacks.
+	big::thread_pool pool(4);
+	test_exact_u64_finds_only_the_planted_value();
+	test_signed_range();
+	pool.destroy();
+
+	return CHECK_RESULT();
+}
@@ -0,0 +1,159 @@
+#include "check.hpp"
+#include "memory/xref_index.hpp"
+#include "threads/thread_pool.hpp"
+
+#include <algorithm>
+#include <cstring>
+#include <thread>
+#include <vector>
+
+using namespace memory;
+
+namespace
+{
+	constexpr uint32_t text_rva     = 0x10'00;
+	constexpr uint32_t text_size    = 0x30'00'00;
+	constexpr uint32_t data_rva     = text_rva + text_size;
+	constexpr uint32_t function_rva = 0x20'00;
+	constexpr uint32_t variable_rva = data_rva + 0x10;
+	constexpr uint32_t not_code_rva = data_rva + 0x80;
+
+	// Hand assembled image: int3 padding everywhere, so only the planted instructions decode to references.
+	class test_image
+	{
+	public:
+		test_image() :
+		    m_bytes(data_rva + 0x10'00, 0xCC)
+		{
+		}
+
+		void put(uint32_t rva, std::initializer_list<uint8_t> bytes)
+		{
+			std::copy(bytes.begin(), bytes.end(), m_bytes.begin() + rva);
+		}
+
+		// rel32 / disp32 relative to the end of the instruction.
+		void put_relative(uint32_t rva, uint32_t next_rva, uint32_t target_rva)
+		{
+			const auto relative = static_cast<int32_t>(target_rva - next_rva);
+			std::memcpy(m_bytes.data() + rva, &relative, sizeof(relative));
+		}
+
+		const uint8_t* data() const
+		{
+			return m_bytes.data();
+		}
+
+		std::size_t size() const
+		{
+			return m_bytes.size();
+		}
+
+	private:
+		std::vector<uint8_t> m_bytes;
+	};
+
+	std::vector<uint32_t> sources(std::span<const xref> xrefs)
+	{
+		std::vector<uint32_t> result;
+		for (const auto& xref : xrefs)
+		{
+			result.push_back(xref.m_source_rva);
+		}
+		return result;
+	}
+
+	void test_xref_index()
+	{
+		test_image image;
+
+		// call / jmp rel32, the last one lands outside of the code and isn't indexed.
+		image.put(0x11'00, {0xE8});
+		image.put_relative(0x11'01, 0x11'05, function_rva);
+		image.put(0x12'00, {0xE9});
+		image.put_relative(0x12'01, 0x12'05, function_rva);
+		image.put(0x13'00, {0xE8});
+		image.put_relative(0x13'01, 0x13'05, not_code_rva);
+
+		// lea rax, [rip + variable]
+		image.put(0x14'00, {0x48, 0x8D, 0x05});
+		image.put_relative(0x14'03, 0x14'07, variable_rva);
+		// mov word ptr [rip + variable], imm16: the 66 prefix shrinks the immediate.
+		image.put(0x15'00, {0x66, 0xC7, 0x05});
+		image.put_relative(0x15'03, 0x15'09, variable_rva);
+		image.put(0x15'07, {0x34, 0x12});
+		// mov qword ptr [rip + variable], imm32
+		image.put(0x16'00, {0x48, 0xC7, 0x05});
+		image.put_relative(0x16'03, 0x16'0B, variable_rva);
+		image.put(0x16'07, {0x44, 0x33, 0x22, 0x11});
+		// add qword ptr [rip + variable], imm8
+		image.put(0x17'00, {0x48, 0x83, 0x05});
+		image.put_relative(0x17'03, 0x17'08, variable_rva);
+		image.put(0x17'07, {0x7F});
+		// add word ptr [rip + variable], imm8: the 66 prefix leaves the imm8 alone.
+		image.put(0x18'00, {0x66, 0x83, 0x05});
+		image.put_relative(0x18'03, 0x18'08, variable_rva);
+		image.put(0x18'07, {0x7F});
+
+		// Same chunking as the constructor, the two instructions below straddle the end of the first and second chunks
+		// (when the hardware leaves that many chunks, a single core decodes the section in one go).
+		big::thread_pool pool(4);
+		const auto thread_count = std::max(1u, std::thread::hardware_concurrency());
+		const auto chunk_size   = std::max<std::size_t>(0x10'00'00, text_size / thread_count + 1);
+		const auto chunk_end    = [chunk_size](std::size_t n)
+		{
+			return text_rva + static_cast<uint32_t>(chunk_size * n < text_size ? chunk_size * n : text_size * n / 3);
+		};
+
+		// call with its rel32 in the next chunk.
+		const auto split_call_rva = chunk_end(1) - 2;
+		image.put(split_call_rva, {0xE8});
+		image.put_relative(split_call_rva + 1, split_call_rva + 5, function_rva);
+		// mov rax, [rip + variable] with its REX prefix in the previous chunk.
+		const auto split_mov_rva = chunk_end(2) - 1;
+		image.put(split_mov_rva, {0x48, 0x8B, 0x05});
+		image.put_relative(split_mov_rva + 3, split_mov_rva + 7, variable_rva);
+
+		const std::vector<pe::section_info> sections = {
+		    {".text", text_rva, text_size, section_type::executable},
+		    {".data", data_rva, 0x10'00, section_type::writable_data},
+		};
+		const xref_index index(image.data(), image.size(), sections);
+		pool.destroy();
+
+		const auto& xrefs = index.xrefs();
+		CHECK(xrefs.size() == 9);
+		CHECK(std::ranges::is_sorted(xrefs,
+		                             [](const xref& a, const xref& b)
+		                             {
+			                             return a.m_target_rva != b.m_target_rva ? a.m_target_rva < b.m_target_rva : a.m_source_rva < b.m_source_rva;
+		                             }));
+
+		const auto function_refs = index.references_to(function_rva);
+		CHECK(sources(function_refs) == std::vector<uint32_t>({0x11'00, 0x12'00, split_call_rva}));
+		CHECK(function_refs.size() == 3 && function_refs[1].m_type == xref_type::jump);
+
+		const auto variable_refs = index.references_to(variable_rva);
+		CHECK(sources(variable_refs) == std::vector<uint32_t>({0x14'00, 0x15'00, 0x16'00, 0x17'00, 0x18'00, split_mov_rva}));
+		CHECK(std::ranges::all_of(variable_refs,
+		                          [](const xref& xref)
+		                          {
+			                          return xref.m_type == xref_type::rip_relative;
+		                          }));
+
+		CHECK(index.references_to(not_code_rva).empty());
+
+		const auto callers = index.callers(handle(const_cast<uint8_t*>(image.data() + function_rva)));
+		CHECK(callers.size() == 2);
+		CHECK(callers.size() == 2 && callers[0].as<const uint8_t*>() == image.data() + 0x11'00);
+		CHECK(callers.size() == 2 && callers[1].as<const uint8_t*>() == image.data() + split_call_rva);
+		CHECK(index.references(handle(const_cast<uint8_t*>(image.data() + variable_rva))).size() == 6);
+	}
+} // namespace
+
+int main()
+{
+	test_xref_index();
+
+	return CHECK_RESULT();
+}
@@ -0,0 +1,284 @@
+#include "memory/multi_pattern.hpp"
+#include "memory/pattern.hpp"
+#include "memory/pe_image.hpp"
+#include "memory/scanner.hpp"
+#include "memory/static_pattern.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <vector>
+
+// Runs a list of signatures against a PE file on disk, without the game running.
+// Reports per signature match count, uniqueness, first rva and scan time, then the time of a single batched pass.
+// Exit code is 0 only when every signature matches exactly once, so it can gate CI on new game builds.
+
+namespace
+{
+	struct options
+	{
+		std::string m_image_path;
+		std::string m_signatures_path;
+		memory::scanner::isa m_isa      = memory::scanner::best_isa();
+		memory::section_type m_sections = memory::section_type::executable;
+		int m_runs                      = 5;
+	};
+
+	struct signature_entry
+	{
+		std::string m_name;
+		std::string m_ida;
+		std::optional<memory::pattern> m_pattern;
+	};
+
+	struct section_span
+	{
+		const uint8_t* m_data;
+		std::size_t m_size;
+		uint32_t m_rva;
+	};
+
+	using clock = std::chrono::steady_clock;
+
+	void print_usage()
+	{
+		std::printf("Usage: signature_bench <image.exe> <signatures.txt> [--runs N] [--isa scalar|sse2|avx2] [--all-sections]\n"
+		            "Signature file: one signature per line, either \"name: 48 8B 05 ? ? ? ?\" or only the IDA string. Lines starting with # are ignored.\n");
+	}
+
+	std::optional<options> parse_options(int argc, char** argv)
+	{
+		options result;
+		std::vector<std::string_view> positional;
+		for (int i = 1; i < argc; i++)
+		{
+			const std::string_view arg = argv[i];
+			if (arg == "--runs" && i + 1 < argc)
+			{
+				result.m_runs = std::max(1, std::atoi(argv[++i]));
+			}
+			else if (arg == "--isa" && i + 1 < argc)
+			{
+				const std::string_view isa = argv[++i];
+				if (isa == "scalar")
+				{
+					result.m_isa = memory::scanner::isa::scalar;
+				}
+				else if (isa == "sse2")
+				{
+					result.m_isa = memory::scanner::isa::sse2;
+				}
+				else if (isa == "avx2")
+				{
+					result.m_isa = memory::scanner::isa::avx2;
+				}
+				else
+				{
+					return std::nullopt;
+				}
+			}
+			else if (arg == "--all-sections")
+			{
+				result.m_sections = memory::section_type::all;
+			}
+			else
+			{
+				positional.push_back(arg);
+			}
+		}
+
+		if (positional.size() != 2)
+		{
+			return std::nullopt;
+		}
+
+		result.m_image_path      = positional[0];
+		result.m_signatures_path = positional[1];
+		return result;
+	}
+
+	std::string_view trim(std::string_view str)
+	{
+		while (str.size() && (str.front() == ' ' || str.front() == '\t'))
+		{
+			str.remove_prefix(1);
+		}
+		while (str.size() && (str.back() == ' ' || str.back() == '\t' || str.back() == '\r'))
+		{
+			str.remove_suffix(1);
+		}
+		return str;
+	}
+
+	std::vector<signature_entry> read_signatures(const std::string& path)
+	{
+		std::vector<signature_entry> entries;
+
+		std::ifstream file(path);
+		std::string line;
+		for (size_t line_number = 1; std::getline(file, line); line_number++)
+		{
+			const auto content = trim(line);
+			if (content.empty() || content.front() == '#')
+			{
+				continue;
+			}
+
+			signature_entry entry;
+			const auto separator = content.find(':');
+			if (separator != std::string_view::npos)
+			{
+				entry.m_name = trim(content.substr(0, separator));
+				entry.m_ida  = trim(content.substr(separator + 1));
+			}
+			else
+			{
+				entry.m_name = "line " + std::to_string(line_number);
+				entry.m_ida  = content;
+			}
+
+			// Strict parse first, the runtime pattern parser silently skips malformed bytes.
+			try
+			{
+				memory::ida::parse(entry.m_ida, nullptr, nullptr);
+				entry.m_pattern.emplace(entry.m_ida);
+			}
+			catch (const std::invalid_argument&)
+			{
+			}
+
+			entries.push_back(std::move(entry));
+		}
+
+		return entries;
+	}
+
+	template<typename F>
+	double best_time_us(int runs, F&& f)
+	{
+		auto best = clock::duration::max();
+		for (int i = 0; i < runs; i++)
+		{
+			const auto start = clock::now();
+			f();
+			best = std::min(best, clock::now() - start);
+		}
+
+		return std::chrono::duration<double, std::micro>(best).count();
+	}
+} // namespace
+
+int main(int argc, char** argv)
+{
+	const auto opts = parse_options(argc, argv);
+	if (!opts)
+	{
+		print_usage();
+		return 2;
+	}
+
+	const memory::pe_image image(opts->m_image_path);
+	if (!image.loaded())
+	{
+		std::fprintf(stderr, "Failed to load PE32+ image %s\n", opts->m_image_path.c_str());
+		return 2;
+	}
+
+	auto entries = read_signatures(opts->m_signatures_path);
+	if (entries.empty())
+	{
+		std::fprintf(stderr, "No signatures in %s\n", opts->m_signatures_path.c_str());
+		return 2;
+	}
+
+	std::vector<section_span> spans;
+	size_t scanned_size = 0;
+	for (const auto& section : image.sections())
+	{
+		if (memory::has_section_type(opts->m_sections, section.m_type))
+		{
+			spans.push_back({image.base() + section.m_rva, section.m_size, section.m_rva});
+			scanned_size += section.m_size;
+		}
+	}
+
+	std::printf("%s: %zu sections, %.2f MiB scanned, timestamp %08X\n\n", opts->m_image_path.c_str(), spans.size(), scanned_size / (1024.0 * 1024.0), image.timestamp());
+	std::printf("%-40s %8s %7s %10s %12s\n", "signature", "matches", "unique", "first rva", "first (us)");
+
+	bool all_unique = true;
+	std::vector<size_t> offsets;
+	for (const auto& entry : entries)
+	{
+		if (!entry.m_pattern)
+		{
+			std::printf("%-40s %8s\n", entry.m_name.c_str(), "malformed");
+			all_unique = false;
+			continue;
+		}
+
+		const auto view = entry.m_pattern->view();
+
+		size_t match_count = 0;
+		std::optional<uint32_t> first_rva;
+		for (const auto& span : spans)
+		{
+			offsets.clear();
+			memory::scanner::find_all(span.m_data, span.m_size, view, offsets, opts->m_isa);
+			if (offsets.size() && !first_rva)
+			{
+				first_rva = span.m_rva + static_cast<uint32_t>(offsets.front());
+			}
+			match_count += offsets.size();
+		}
+
+		// Time of what a live scan pays: stop at the first match.
+		const auto first_time = best_time_us(opts->m_runs,
+		                                     [&]
+		                                     {
+			                                     for (const auto& span : spans)
+			                                     {
+				                                     if (memory::scanner::find_first(span.m_data, span.m_size, view, opts->m_isa) != memory::scanner::npos)
+				                                     {
+					                                     break;
+				                                     }
+			                                     }
+		                                     });
+
+		all_unique &= match_count == 1;
+		char first_rva_text[16] = "-";
+		if (first_rva)
+		{
+			std::snprintf(first_rva_text, sizeof(first_rva_text), "%08X", *first_rva);
+		}
+
+		std::printf("%-40s %8zu %7s %10s %12.1f\n", entry.m_name.c_str(), match_count, match_count == 1 ? "yes" : "no", first_rva_text, first_time);
+	}
+
+	std::vector<memory::scanner::pattern_view> views;
+	for (const auto& entry : entries)
+	{
+		if (entry.m_pattern)
+		{
+			views.push_back(entry.m_pattern->view());
+		}
+	}
+
+	const memory::scanner::multi_pattern matcher(views);
+	const auto batch_time = best_time_us(opts->m_runs,
+	                                     [&]
+	                                     {
+		                                     for (const auto& span : spans)
+		                                     {
+			                                     matcher.find_first(span.m_data, span.m_size);
+		                                     }
+	                                     });
+
+	std::printf("\nSingle pass over %zu signatures: %.1f us\n", views.size(), batch_time);
+
+	return all_unique ? 0 : 1;
+}